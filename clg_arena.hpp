@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGARENA_HPP
+#define CLGARENA_HPP
+
+#ifndef CLGMATH_HPP
+  #include "clg_math.hpp"
+#endif
+
+/*
+ *
+ * A frame arena; a bump allocator for scratch arrays that only live until the next reset(). Allocating is a pointer
+ * bump, and reset() is O(1). Nothing is destructed, so it only hands out trivially destructible types; which is every
+ * vector, matrix, and rect type in the library. Allocations are aligned to 16 bytes by default, or up to 64; enough
+ * for SSE, AVX, AVX-512, and cache lines.
+ *
+ * A frame that outgrows the arena spills into overflow blocks, so earlier allocations stay put. The next reset() then
+ * grows the arena to hold the whole high-water mark in one block, so steady state frames never touch the heap.
+ *
+ * It isn't thread safe; give each thread its own.
+ *
+ * Example:
+ *  clg::frame_arena scratch(1 << 20);
+ *  ...
+ *  scratch.reset();                                                    // once a frame
+ *  auto bones = scratch.allocate<clg::mat4, 64>(bone_count);             // uninitialized
+ *  std::vector<clg::vec4, clg::arena_allocator<clg::vec4>> lights{ clg::arena_allocator<clg::vec4>(scratch) };
+ *
+ */
+
+namespace clg
+{
+    struct arena_statistics
+    {
+        size_t capacity;            // bytes in the primary block
+        size_t used;                // bytes handed out since the last reset(), including alignment padding and the tails
+                                    // of blocks that were too full for the next allocation
+        size_t high_water_mark;     // most bytes used in any one frame
+        size_t allocation_count;    // allocations since the last reset()
+        size_t overflow_count;      // overflow blocks allocated since the last reset()
+    };
+
+    class frame_arena
+    {
+    public:
+        static constexpr size_t default_alignment = 16;
+        static constexpr size_t max_alignment = 64;
+
+        explicit frame_arena(const size_t capacity = 0)
+        {
+            reserve(capacity);
+        }
+
+        frame_arena(const frame_arena&) = delete;
+        frame_arena& operator =(const frame_arena&) = delete;
+
+        // Gets count uninitialized elements.
+        template<typename T, size_t Alignment = (alignof(T) > default_alignment ? alignof(T) : default_alignment)>
+        T* allocate(const size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "frame_arena never runs destructors");
+            static_assert(Alignment >= alignof(T), "alignment is too small for the type");
+            return static_cast<T*>(allocate_bytes<Alignment>(count * sizeof(T)));
+        }
+
+        template<size_t Alignment = default_alignment>
+        void* allocate_bytes(const size_t bytes)
+        {
+            static_assert(0 == (Alignment & (Alignment - 1)) && Alignment <= max_alignment, "alignment must be a power of two, up to 64");
+            auto result = align_pointer<Alignment>(_cursor);
+            if (static_cast<size_t>(result - _cursor) + bytes > static_cast<size_t>(_end - _cursor))
+            {
+                result = align_pointer<Alignment>(overflow(bytes + Alignment));
+            }
+
+            _used += static_cast<size_t>(result - _cursor) + bytes;
+            _high_water_mark = std::max(_high_water_mark, _used);
+            _allocation_count++;
+            _cursor = result + bytes;
+            return result;
+        }
+
+        // Frees everything allocated since the last reset(); growing the arena first if the frame overflowed it.
+        void reset()
+        {
+            if (!_overflow.empty())
+            {
+                // The high-water mark counts the wasted tails and padding, so it's past the capacity; but make sure.
+                _overflow.clear();
+                reserve(round_up_to_nearest_power_of_two(std::max(_high_water_mark, _capacity + 1)));
+            }
+
+            _cursor = _begin;
+            _end = _begin + _capacity;
+            _used = 0;
+            _allocation_count = 0;
+        }
+
+        // Grows the primary block to at least capacity bytes; invalidating everything allocated since the last reset().
+        void reserve(const size_t capacity)
+        {
+            if (capacity <= _capacity && nullptr != _begin)
+            {
+                return;
+            }
+
+            _storage.assign(capacity + max_alignment - 1, 0u);
+            _begin = align_pointer<max_alignment>(_storage.data());
+            _end = _begin + capacity;
+            _capacity = capacity;
+            _cursor = _begin;
+            _used = 0;
+            _allocation_count = 0;
+        }
+
+        arena_statistics statistics() const
+        {
+            return arena_statistics{ _capacity, _used, _high_water_mark, _allocation_count, _overflow.size() };
+        }
+
+    private:
+        uint8_t* overflow(const size_t bytes)
+        {
+            // The rest of the current block is wasted; count it, so the next reset() grows the arena enough.
+            _used += static_cast<size_t>(_end - _cursor);
+
+            // Each overflow block is at least as big as the arena, so a frame can't spill a block per allocation.
+            _overflow.emplace_back(std::max(bytes, _capacity));
+            auto& block = _overflow.back();
+            _cursor = block.data();
+            _end = block.data() + block.size();
+            return _cursor;
+        }
+
+        std::vector<uint8_t>                _storage;
+        std::vector<std::vector<uint8_t>>   _overflow;
+        uint8_t*                            _begin = nullptr;
+        uint8_t*                            _end = nullptr;
+        uint8_t*                            _cursor = nullptr;
+        size_t                              _capacity = 0;
+        size_t                              _used = 0;
+        size_t                              _high_water_mark = 0;
+        size_t                              _allocation_count = 0;
+    };
+
+    // A standard library allocator that takes from a frame_arena; deallocating does nothing. Containers using it must
+    // be gone (or at least never touched again) by the arena's next reset().
+    template<typename T>
+    class arena_allocator
+    {
+    public:
+        using value_type = T;
+
+        explicit arena_allocator(frame_arena& arena)
+            : _arena(&arena) { }
+
+        template<typename U>
+        arena_allocator(const arena_allocator<U>& original)
+            : _arena(original.arena()) { }
+
+        T* allocate(const size_t count)
+        {
+            return _arena->allocate<T>(count);
+        }
+
+        void deallocate(T* const, const size_t) { }
+
+        frame_arena* arena() const
+        {
+            return _arena;
+        }
+
+        template<typename U>
+        bool operator ==(const arena_allocator<U>& rhs) const
+        {
+            return _arena == rhs.arena();
+        }
+
+        template<typename U>
+        bool operator !=(const arena_allocator<U>& rhs) const
+        {
+            return _arena != rhs.arena();
+        }
+
+    private:
+        frame_arena* _arena;
+    };
+} // namespace clg
+
+#endif
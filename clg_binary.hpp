@@ -0,0 +1,593 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGBINARY_HPP
+#define CLGBINARY_HPP
+
+#ifndef CLGRECTANGLE_HPP
+  #include "clg_rectangle.hpp"
+#endif
+#ifndef CLGMATRIX_HPP
+  #include "clg_matrix.hpp"
+#endif
+
+/*
+ *
+ * Versioned binary container for arrays of vectors, matrices, rects, and scalars.
+ *
+ * The vec, mat, and rect class templates are laid out exactly like arrays of their scalars, so a file can hold the
+ * elements as they are in memory and be read back without any parsing. Once the file is mapped (or loaded) the
+ * sections are used in place, through typed, read-only views.
+ *
+ * Layout (native byte order, every offset is from the start of the file):
+ *  binary_header                               32 bytes; "CLGB", version, byte order mark, alignment, section count
+ *  binary_section[section_count]               32 bytes each; id, type tag, element size, offset, and count
+ *  section data                                each section starts at a multiple of the header's alignment
+ *
+ * The type tag records the shape (scalar, vector, matrix, or rect), the scalar kind and size, the dimensions, and
+ * the rect policies; view<T>() only succeeds when they match T. Vectors of the same size and scalar are
+ * interchangeable, e.g. an rgba section may be viewed as vec4.
+ *
+ * Example:
+ *  clg::binary_writer writer;
+ *  writer.add(1, positions.data(), positions.size()); // the spans must stay alive until written
+ *  writer.add(2, &model_matrix, 1);
+ *  std::vector<uint8_t> file(writer.size());
+ *  writer.write(file.data(), file.size());
+ *
+ *  clg::mapped_file mapping("scene.clgb"); // available when <windows.h>, or <sys/mman.h>, is included first
+ *  clg::binary_reader reader(mapping.data(), mapping.size());
+ *  const auto positions = reader.view<clg::vec3>(reader.find(1));
+ *
+ */
+
+namespace clg
+{
+    constexpr uint16_t binary_version = 1;
+    constexpr uint16_t binary_byte_order_mark = 0x0102;
+
+    enum class binary_shape : uint8_t
+    {
+        scalar = 0,
+        vector = 1,
+        matrix = 2,
+        rect = 3,
+    };
+
+    enum class binary_scalar : uint8_t
+    {
+        signed_integer = 0,
+        unsigned_integer = 1,
+        floating_point = 2,
+    };
+
+    // binary_type::flags
+    constexpr uint8_t binary_inverted_y_axis = 0x01;
+    constexpr uint8_t binary_right_open_intervals = 0x02;
+
+    struct binary_type
+    {
+        binary_shape    shape;
+        binary_scalar   scalar;
+        uint8_t         scalar_size;    // bytes
+        uint8_t         flags;          // rect policies
+        uint16_t        columns;        // vector dimensions, or matrix columns
+        uint16_t        rows;           // matrix rows; otherwise 1
+
+        constexpr bool operator==(const binary_type& rhs) const
+        {
+            return shape == rhs.shape && scalar == rhs.scalar && scalar_size == rhs.scalar_size &&
+                flags == rhs.flags && columns == rhs.columns && rows == rhs.rows;
+        }
+
+        constexpr bool operator!=(const binary_type& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        // Size of an element in bytes.
+        constexpr uint32_t element_size() const
+        {
+            return uint32_t(scalar_size) * columns * rows * (binary_shape::rect == shape ? 4u : 1u);
+        }
+    };
+
+    struct binary_header
+    {
+        char            magic[4];       // "CLGB"
+        uint16_t        version;        // binary_version
+        uint16_t        byte_order;     // binary_byte_order_mark, as written by the producer
+        uint32_t        alignment;      // of each section's data; a power of two
+        uint32_t        section_count;
+        uint64_t        file_size;
+        uint64_t        reserved;
+    };
+
+    struct binary_section
+    {
+        uint32_t        id;             // chosen by the producer
+        binary_type     type;
+        uint32_t        element_size;
+        uint64_t        offset;
+        uint64_t        count;          // of elements
+    };
+
+    static_assert(sizeof(binary_type) == 8, "binary_type must be packed");
+    static_assert(sizeof(binary_header) == 32, "binary_header must be packed");
+    static_assert(sizeof(binary_section) == 32, "binary_section must be packed");
+
+    namespace impl
+    {
+        template<typename T, typename = void> struct has_column_count : std::false_type {};
+        template<typename T> struct has_column_count<T, std::void_t<decltype(T::column_count)>> : std::true_type {};
+        template<typename T, typename = void> struct has_dimension_count : std::false_type {};
+        template<typename T> struct has_dimension_count<T, std::void_t<decltype(T::dimension_count)>> : std::true_type {};
+        template<typename T, typename = void> struct has_bounds_check_policy : std::false_type {};
+        template<typename T> struct has_bounds_check_policy<T, std::void_t<typename T::bounds_check_policy>> : std::true_type {};
+
+        template<typename ScalarT>
+        inline constexpr binary_type make_binary_type(const binary_shape shape, const uint16_t columns, const uint16_t rows, const uint8_t flags)
+        {
+            static_assert(std::is_arithmetic_v<ScalarT> && !std::is_same_v<ScalarT, bool>, "unsupported scalar type");
+            const auto scalar = std::is_floating_point_v<ScalarT> ? binary_scalar::floating_point :
+                std::is_signed_v<ScalarT> ? binary_scalar::signed_integer : binary_scalar::unsigned_integer;
+            return binary_type{ shape, scalar, uint8_t(sizeof(ScalarT)), flags, columns, rows };
+        }
+
+        // Rounds up to a multiple of a power of two; 64-bit for file offsets.
+        inline constexpr uint64_t round_up_to_alignment(const uint64_t value, const uint64_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    } // namespace impl
+
+    // Gets the type tag for a scalar, base_vec, mat, or rect type.
+    template<typename T>
+    inline constexpr binary_type binary_type_of()
+    {
+        static_assert(std::is_standard_layout_v<T>, "binary sections require standard layout elements");
+        if constexpr (impl::has_column_count<T>::value)
+        {
+            using scalar_type = typename T::scalar_type;
+            static_assert(sizeof(T) == sizeof(scalar_type) * T::element_count, "unexpected matrix layout");
+            return impl::make_binary_type<scalar_type>(binary_shape::matrix, uint16_t(T::column_count), uint16_t(T::row_count), 0);
+        }
+        else if constexpr (impl::has_dimension_count<T>::value)
+        {
+            using scalar_type = typename T::scalar_type;
+            static_assert(sizeof(T) == sizeof(scalar_type) * T::dimension_count, "unexpected vector layout");
+            return impl::make_binary_type<scalar_type>(binary_shape::vector, uint16_t(T::dimension_count), 1, 0);
+        }
+        else if constexpr (impl::has_bounds_check_policy<T>::value)
+        {
+            using scalar_type = typename T::scalar_type;
+            static_assert(sizeof(T) == sizeof(scalar_type) * 4, "unexpected rect layout");
+            const uint8_t flags =
+                (std::is_same_v<typename T::y_axes_policy, InvertedYAxis> ? binary_inverted_y_axis : 0) |
+                (std::is_same_v<typename T::bounds_check_policy, RightOpenIntervals> ? binary_right_open_intervals : 0);
+            return impl::make_binary_type<scalar_type>(binary_shape::rect, 1, 1, flags);
+        }
+        else
+        {
+            return impl::make_binary_type<T>(binary_shape::scalar, 1, 1, 0);
+        }
+    }
+
+    // Read-only view of a section's elements; used in place.
+    template<typename T>
+    class binary_view
+    {
+    public:
+        using value_type = T;
+
+        constexpr binary_view() { }
+        constexpr binary_view(const T* const elements, const size_t count) : _data(elements), _size(count) { }
+
+        constexpr const T* data() const { return _data; }
+        constexpr size_t size() const { return _size; }
+        constexpr bool empty() const { return 0 == _size; }
+        constexpr const T* begin() const { return _data; }
+        constexpr const T* end() const { return _data + _size; }
+
+        constexpr const T& operator[](const size_t index) const
+        {
+            assert(index < _size);
+            return _data[index];
+        }
+
+    private:
+        const T*    _data = nullptr;
+        size_t      _size = 0;
+    };
+
+    // Collects spans of elements, and writes them as one binary container.
+    // NOTE: The spans aren't copied; they need to stay alive until they're written.
+    class binary_writer
+    {
+    public:
+        explicit binary_writer(const uint32_t alignment = 64)
+            : _alignment(alignment)
+        {
+            assert(0 != alignment && 0 == (alignment & (alignment - 1)));
+        }
+
+        void clear()
+        {
+            _sections.clear();
+            _data.clear();
+        }
+
+        template<typename T>
+        void add(const uint32_t id, const T* const elements, const size_t count)
+        {
+            static_assert(sizeof(T) <= 0xffffffffu, "element type is too big");
+            assert(nullptr != elements || 0 == count);
+            assert(alignof(T) <= _alignment);
+            binary_section section{ id, binary_type_of<T>(), uint32_t(sizeof(T)), 0, uint64_t(count) };
+            _sections.push_back(section);
+            _data.push_back(elements);
+        }
+
+        size_t section_count() const
+        {
+            return _sections.size();
+        }
+
+        // Size of the file in bytes.
+        uint64_t size() const
+        {
+            auto offset = uint64_t(sizeof(binary_header) + sizeof(binary_section) * _sections.size());
+            for (const auto& section : _sections)
+            {
+                offset = impl::round_up_to_alignment(offset, _alignment) + section.count * section.element_size;
+            }
+            return offset;
+        }
+
+        // Writes the file through a sink: bool sink(const void* bytes, size_t byte_count).
+        // Returns false as soon as the sink does.
+        template<typename sink_type>
+        bool write(sink_type sink) const
+        {
+            binary_header header{ { 'C', 'L', 'G', 'B' }, binary_version, binary_byte_order_mark, _alignment, uint32_t(_sections.size()), size(), 0 };
+            if (!sink(&header, sizeof(header)))
+            {
+                return false;
+            }
+
+            auto offset = uint64_t(sizeof(binary_header) + sizeof(binary_section) * _sections.size());
+            for (auto section : _sections)
+            {
+                offset = impl::round_up_to_alignment(offset, _alignment);
+                section.offset = offset;
+                offset += section.count * section.element_size;
+                if (!sink(&section, sizeof(section)))
+                {
+                    return false;
+                }
+            }
+
+            static constexpr uint8_t padding[64] = {};
+            offset = uint64_t(sizeof(binary_header) + sizeof(binary_section) * _sections.size());
+            for (size_t i = 0; i < _sections.size(); i++)
+            {
+                for (auto gap = impl::round_up_to_alignment(offset, _alignment) - offset; 0 != gap;)
+                {
+                    const auto bytes = min(gap, uint64_t(sizeof(padding)));
+                    if (!sink(padding, size_t(bytes)))
+                    {
+                        return false;
+                    }
+                    gap -= bytes;
+                    offset += bytes;
+                }
+
+                const auto bytes = _sections[i].count * _sections[i].element_size;
+                if (0 != bytes && !sink(_data[i], size_t(bytes)))
+                {
+                    return false;
+                }
+                offset += bytes;
+            }
+            return true;
+        }
+
+        // Writes the file into memory. Returns false if it doesn't fit.
+        bool write(void* const destination, const uint64_t capacity) const
+        {
+            assert(nullptr != destination || 0 == capacity);
+            if (capacity < size())
+            {
+                return false;
+            }
+
+            auto* cursor = static_cast<uint8_t*>(destination);
+            return write([&cursor](const void* const bytes, const size_t byte_count)
+            {
+                std::memcpy(cursor, bytes, byte_count);
+                cursor += byte_count;
+                return true;
+            });
+        }
+
+    private:
+        uint32_t                    _alignment;
+        std::vector<binary_section> _sections;
+        std::vector<const void*>    _data;
+    };
+
+    // Validates a binary container in memory, and gets typed views of its sections.
+    // NOTE: Nothing is copied; the memory needs to outlive the reader and its views.
+    class binary_reader
+    {
+    public:
+        static constexpr size_t npos = ~size_t(0);
+
+        binary_reader() { }
+
+        binary_reader(const void* const data, const size_t size)
+        {
+            open(data, size);
+        }
+
+        // Returns false if the data isn't a complete binary container, in this byte order, of a supported version.
+        bool open(const void* const data, const size_t size)
+        {
+            close();
+            if (nullptr == data || size < sizeof(binary_header))
+            {
+                return false;
+            }
+
+            const auto* const header = static_cast<const binary_header*>(data);
+            const auto alignment = header->alignment;
+            if (0 != std::memcmp(header->magic, "CLGB", 4) ||
+                binary_version < header->version ||
+                binary_byte_order_mark != header->byte_order ||
+                0 == alignment || 0 != (alignment & (alignment - 1)) ||
+                header->file_size > size ||
+                header->section_count > (size - sizeof(binary_header)) / sizeof(binary_section))
+            {
+                return false;
+            }
+
+            const auto* const sections = reinterpret_cast<const binary_section*>(header + 1);
+            for (auto i = 0u; i < header->section_count; i++)
+            {
+                const auto& section = sections[i];
+                if (section.type.element_size() != section.element_size ||
+                    0 != section.offset % alignment ||
+                    section.offset > size ||
+                    section.count > (size - section.offset) / max(section.element_size, 1u))
+                {
+                    return false;
+                }
+            }
+
+            _data = static_cast<const uint8_t*>(data);
+            _header = header;
+            _sections = sections;
+            return true;
+        }
+
+        void close()
+        {
+            _data = nullptr;
+            _header = nullptr;
+            _sections = nullptr;
+        }
+
+        bool is_open() const
+        {
+            return nullptr != _header;
+        }
+
+        const binary_header& header() const
+        {
+            assert(is_open());
+            return *_header;
+        }
+
+        size_t section_count() const
+        {
+            return is_open() ? _header->section_count : 0;
+        }
+
+        const binary_section& section(const size_t index) const
+        {
+            assert(index < section_count());
+            return _sections[index];
+        }
+
+        // Gets the index of the first section with the id, or npos.
+        size_t find(const uint32_t id) const
+        {
+            for (size_t i = 0; i < section_count(); i++)
+            {
+                if (id == _sections[i].id)
+                {
+                    return i;
+                }
+            }
+            return npos;
+        }
+
+        // Gets a view of a section's elements. The view is empty if the index is npos, the section's type tag
+        // doesn't match T, or the mapping isn't aligned for T.
+        template<typename T>
+        binary_view<T> view(const size_t index) const
+        {
+            if (index >= section_count())
+            {
+                return binary_view<T>();
+            }
+
+            const auto& section = _sections[index];
+            const auto* const elements = _data + section.offset;
+            if (binary_type_of<T>() != section.type ||
+                0 != reinterpret_cast<uintptr_t>(elements) % alignof(T) ||
+                section.count > ~size_t(0) / sizeof(T))
+            {
+                return binary_view<T>();
+            }
+            return binary_view<T>(reinterpret_cast<const T*>(elements), size_t(section.count));
+        }
+
+    private:
+        const uint8_t*          _data = nullptr;
+        const binary_header*    _header = nullptr;
+        const binary_section*   _sections = nullptr;
+    };
+
+#if defined(_WINDOWS_) || defined(_SYS_MMAN_H) || defined(_SYS_MMAN_H_)
+    // Read-only memory mapping of a whole file.
+    // NOTE: On POSIX systems, include <sys/mman.h>, <sys/stat.h>, <fcntl.h>, and <unistd.h>; on Windows <windows.h>.
+    class mapped_file
+    {
+    public:
+        mapped_file() { }
+
+        explicit mapped_file(const char* const path)
+        {
+            open(path);
+        }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&& original) noexcept
+            : _data(original._data)
+            , _size(original._size)
+        {
+            original._data = nullptr;
+            original._size = 0;
+        }
+
+        mapped_file& operator=(mapped_file&& original) noexcept
+        {
+            if (this != &original)
+            {
+                close();
+                _data = original._data;
+                _size = original._size;
+                original._data = nullptr;
+                original._size = 0;
+            }
+            return *this;
+        }
+
+        ~mapped_file()
+        {
+            close();
+        }
+
+#ifdef _WINDOWS_
+        bool open(const char* const path)
+        {
+            close();
+            const auto file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            return map(file);
+        }
+
+        bool open(const wchar_t* const path)
+        {
+            close();
+            const auto file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            return map(file);
+        }
+
+        void close()
+        {
+            if (nullptr != _data)
+            {
+                UnmapViewOfFile(_data);
+            }
+            _data = nullptr;
+            _size = 0;
+        }
+#else
+        bool open(const char* const path)
+        {
+            close();
+            const auto file = ::open(path, O_RDONLY);
+            if (file < 0)
+            {
+                return false;
+            }
+
+            struct stat status;
+            if (0 == fstat(file, &status) && 0 < status.st_size)
+            {
+                const auto size = static_cast<size_t>(status.st_size);
+                const auto data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+                if (MAP_FAILED != data)
+                {
+                    _data = data;
+                    _size = size;
+                }
+            }
+            ::close(file); // the mapping keeps the file open
+            return is_open();
+        }
+
+        void close()
+        {
+            if (nullptr != _data)
+            {
+                munmap(_data, _size);
+            }
+            _data = nullptr;
+            _size = 0;
+        }
+#endif
+
+        bool is_open() const
+        {
+            return nullptr != _data;
+        }
+
+        const void* data() const
+        {
+            return _data;
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+    private:
+#ifdef _WINDOWS_
+        bool map(const HANDLE file)
+        {
+            if (INVALID_HANDLE_VALUE == file)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER size;
+            if (GetFileSizeEx(file, &size) && 0 < size.QuadPart)
+            {
+                const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (nullptr != mapping)
+                {
+                    _data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    _size = nullptr != _data ? static_cast<size_t>(size.QuadPart) : 0;
+                    CloseHandle(mapping); // the view keeps the mapping open
+                }
+            }
+            CloseHandle(file);
+            return is_open();
+        }
+#endif
+
+        void*   _data = nullptr;
+        size_t  _size = 0;
+    };
+#endif
+} // namespace clg
+
+#endif
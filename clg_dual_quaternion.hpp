@@ -0,0 +1,323 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGDUALQUATERNION_HPP
+#define CLGDUALQUATERNION_HPP
+
+#ifndef CLGMATRIX_HPP
+  #include "clg_matrix.hpp"
+#endif
+
+/*
+ *
+ * Quaternions, stored in a vec4 as ( x, y, z, w ) where w is the scalar part, and dual quaternions for rigid
+ * transforms (a rotation followed by a translation).
+ *
+ * A unit dual quaternion is the pair ( real, dual ), where real is the rotation and dual = 0.5 * ( t, 0 ) * real for
+ * the translation t. Blending dual quaternions and normalizing the result keeps the transform rigid, which avoids the
+ * "candy-wrapper" collapse of blended matrices.
+ *
+ * The conversions from matrices expect rigid transforms, like translation_matrix(t) * rotation; any scale or shear is
+ * discarded.
+ *
+ * Memory layout is the same as scalar_type[8]: real.x, real.y, real.z, real.w, dual.x, dual.y, dual.z, dual.w
+ *
+ */
+
+namespace clg
+{
+    // Hamilton product; the rotation rhs followed by the rotation lhs.
+    template<typename ScalarT>
+    inline constexpr impl::vec<ScalarT, 4> quat_multiply(const impl::vec<ScalarT, 4>& lhs, const impl::vec<ScalarT, 4>& rhs)
+    {
+        return impl::vec<ScalarT, 4>(
+            lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+            lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+            lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+            lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z
+            );
+    }
+
+    template<typename ScalarT>
+    inline constexpr impl::vec<ScalarT, 4> quat_conjugate(const impl::vec<ScalarT, 4>& q)
+    {
+        return impl::vec<ScalarT, 4>(-q.x, -q.y, -q.z, q.w);
+    }
+
+    // Rotates a vector by a unit quaternion.
+    template<typename ScalarT>
+    inline constexpr impl::vec<ScalarT, 3> quat_rotate(const impl::vec<ScalarT, 4>& q, const impl::vec<ScalarT, 3>& v)
+    {
+        // v + 2 * cross(q.xyz, cross(q.xyz, v) + q.w * v)
+        const impl::vec<ScalarT, 3> axis(q.x, q.y, q.z);
+        return v + axis.cross(axis.cross(v) + v * q.w) * ScalarT(2);
+    }
+
+    // Gets the unit quaternion for the rotation in the upper 3x3 of a matrix; which must be orthonormal.
+    template<typename ScalarT, unsigned int Size>
+    inline impl::vec<ScalarT, 4> quat_from_matrix(const impl::mat<ScalarT, Size, Size>& m)
+    {
+        static_assert(3 == Size || 4 == Size, "quaternions can only be extracted from 3x3 or 4x4 matrices");
+        const auto trace = m.row_col(0, 0) + m.row_col(1, 1) + m.row_col(2, 2);
+        impl::vec<ScalarT, 4> q;
+        if (trace > ScalarT(0))
+        {
+            const auto s = std::sqrt(trace + ScalarT(1)) * ScalarT(2);
+            q = impl::vec<ScalarT, 4>(
+                (m.row_col(2, 1) - m.row_col(1, 2)) / s,
+                (m.row_col(0, 2) - m.row_col(2, 0)) / s,
+                (m.row_col(1, 0) - m.row_col(0, 1)) / s,
+                ScalarT(0.25) * s);
+        }
+        else if (m.row_col(0, 0) > m.row_col(1, 1) && m.row_col(0, 0) > m.row_col(2, 2))
+        {
+            const auto s = std::sqrt(ScalarT(1) + m.row_col(0, 0) - m.row_col(1, 1) - m.row_col(2, 2)) * ScalarT(2);
+            q = impl::vec<ScalarT, 4>(
+                ScalarT(0.25) * s,
+                (m.row_col(0, 1) + m.row_col(1, 0)) / s,
+                (m.row_col(0, 2) + m.row_col(2, 0)) / s,
+                (m.row_col(2, 1) - m.row_col(1, 2)) / s);
+        }
+        else if (m.row_col(1, 1) > m.row_col(2, 2))
+        {
+            const auto s = std::sqrt(ScalarT(1) + m.row_col(1, 1) - m.row_col(0, 0) - m.row_col(2, 2)) * ScalarT(2);
+            q = impl::vec<ScalarT, 4>(
+                (m.row_col(0, 1) + m.row_col(1, 0)) / s,
+                ScalarT(0.25) * s,
+                (m.row_col(1, 2) + m.row_col(2, 1)) / s,
+                (m.row_col(0, 2) - m.row_col(2, 0)) / s);
+        }
+        else
+        {
+            const auto s = std::sqrt(ScalarT(1) + m.row_col(2, 2) - m.row_col(0, 0) - m.row_col(1, 1)) * ScalarT(2);
+            q = impl::vec<ScalarT, 4>(
+                (m.row_col(0, 2) + m.row_col(2, 0)) / s,
+                (m.row_col(1, 2) + m.row_col(2, 1)) / s,
+                ScalarT(0.25) * s,
+                (m.row_col(1, 0) - m.row_col(0, 1)) / s);
+        }
+        return q.unit();
+    }
+
+    // Gets the rotation matrix of a unit quaternion.
+    template<typename ScalarT>
+    inline constexpr impl::mat<ScalarT, 4, 4> quat_to_matrix(const impl::vec<ScalarT, 4>& q)
+    {
+        const auto xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        const auto xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        const auto wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+        const ScalarT one(1), two(2), zero(0);
+        const ScalarT scalars[] =
+        {
+            one - two * (yy + zz),  two * (xy + wz),        two * (xz - wy),        zero, // column vector 1
+            two * (xy - wz),        one - two * (xx + zz),  two * (yz + wx),        zero, // column vector 2
+            two * (xz + wy),        two * (yz - wx),        one - two * (xx + yy),  zero, // ...
+            zero,                   zero,                   zero,                   one
+        };
+        return impl::mat<ScalarT, 4, 4>(scalars);
+    }
+
+    // Blends unit quaternions along the shorter arc, then normalizes; cheap, but it speeds up through the middle.
+    template<typename ScalarT>
+    inline impl::vec<ScalarT, 4> quat_nlerp(const impl::vec<ScalarT, 4>& a, const impl::vec<ScalarT, 4>& b, const ScalarT t)
+    {
+        // q and -q are the same rotation; flip b into a's hemisphere for the shorter arc.
+        const auto weight = a.dot(b) < ScalarT(0) ? -t : t;
+        return (a * (ScalarT(1) - t) + b * weight).unit();
+    }
+
+    // Blends unit quaternions along the shorter arc at a constant angular speed.
+    template<typename ScalarT>
+    inline impl::vec<ScalarT, 4> quat_slerp(const impl::vec<ScalarT, 4>& a, const impl::vec<ScalarT, 4>& b, const ScalarT t)
+    {
+        const auto cosine = a.dot(b);
+        const auto sign = cosine < ScalarT(0) ? ScalarT(-1) : ScalarT(1);
+        const auto abs_cosine = cosine * sign;
+        if (abs_cosine > ScalarT(0.9995))
+        {
+            // Nearly the same rotation; the sines vanish, and nlerp is just as good.
+            return (a * (ScalarT(1) - t) + b * (t * sign)).unit();
+        }
+
+        const auto angle = std::acos(abs_cosine);
+        const auto inverse_sine = ScalarT(1) / std::sqrt(ScalarT(1) - abs_cosine * abs_cosine);
+        return a * (std::sin((ScalarT(1) - t) * angle) * inverse_sine) + b * (std::sin(t * angle) * inverse_sine * sign);
+    }
+
+    // Blends count pairs of unit quaternions by quat_nlerp(a[i], b[i], interp(t[i])); results may be a or b.
+    template<typename ScalarT, typename interpolate_func = interp::linear>
+    inline void quat_nlerp(
+        const impl::vec<ScalarT, 4>* const a,
+        const impl::vec<ScalarT, 4>* const b,
+        const float* const t,
+        impl::vec<ScalarT, 4>* const results,
+        const size_t count,
+        const interpolate_func interp = interpolate_func()
+        )
+    {
+        assert((nullptr != a && nullptr != b && nullptr != t && nullptr != results) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("quat_nlerp", count);
+        for (auto i = size_t(0); i < count; i++)
+        {
+            results[i] = quat_nlerp(a[i], b[i], static_cast<ScalarT>(interp(t[i])));
+        }
+    }
+
+    // Blends count pairs of unit quaternions by quat_slerp(a[i], b[i], interp(t[i])); results may be a or b.
+    template<typename ScalarT, typename interpolate_func = interp::linear>
+    inline void quat_slerp(
+        const impl::vec<ScalarT, 4>* const a,
+        const impl::vec<ScalarT, 4>* const b,
+        const float* const t,
+        impl::vec<ScalarT, 4>* const results,
+        const size_t count,
+        const interpolate_func interp = interpolate_func()
+        )
+    {
+        assert((nullptr != a && nullptr != b && nullptr != t && nullptr != results) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("quat_slerp", count);
+        for (auto i = size_t(0); i < count; i++)
+        {
+            results[i] = quat_slerp(a[i], b[i], static_cast<ScalarT>(interp(t[i])));
+        }
+    }
+} // namespace clg
+
+namespace clg { namespace impl
+{
+    template<typename ScalarT = float>
+    class dual_quat
+    {
+    public:
+        using scalar_type = ScalarT;
+        using quat_type = vec<scalar_type, 4>;
+        using vec3_type = vec<scalar_type, 3>;
+        using mat4_type = mat<scalar_type, 4, 4>;
+
+        // identity
+        constexpr dual_quat()
+            : real(scalar_type(0), scalar_type(0), scalar_type(0), scalar_type(1))
+            , dual(scalar_type(0), scalar_type(0), scalar_type(0), scalar_type(0))
+        {
+        }
+
+        constexpr dual_quat(const quat_type& real_part, const quat_type& dual_part)
+            : real(real_part)
+            , dual(dual_part)
+        {
+        }
+
+        // rotation, then translation
+        constexpr dual_quat(const quat_type& rotation, const vec3_type& translation)
+            : real(rotation)
+            , dual(quat_multiply(quat_type(translation, scalar_type(0)), rotation) * scalar_type(0.5))
+        {
+        }
+
+        // from a rigid transform, like translation_matrix(t) * rotation
+        explicit dual_quat(const mat4_type& rigid)
+            : dual_quat(quat_from_matrix(rigid), vec3_type(rigid(3, 0), rigid(3, 1), rigid(3, 2)))
+        {
+        }
+
+        constexpr bool operator ==(const dual_quat& rhs) const
+        {
+            return real == rhs.real && dual == rhs.dual;
+        }
+
+        constexpr bool operator !=(const dual_quat& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        // the transform rhs followed by this one
+        constexpr dual_quat operator *(const dual_quat& rhs) const
+        {
+            return dual_quat(quat_multiply(real, rhs.real), quat_multiply(real, rhs.dual) + quat_multiply(dual, rhs.real));
+        }
+
+        constexpr dual_quat operator *(const scalar_type rhs) const
+        {
+            return dual_quat(real * rhs, dual * rhs);
+        }
+
+        constexpr dual_quat operator +(const dual_quat& rhs) const
+        {
+            return dual_quat(real + rhs.real, dual + rhs.dual);
+        }
+
+        constexpr dual_quat& operator +=(const dual_quat& rhs)
+        {
+            real += rhs.real;
+            dual += rhs.dual;
+            return *this;
+        }
+
+        // gets the inverse of a unit dual quaternion
+        constexpr dual_quat conjugate() const
+        {
+            return dual_quat(quat_conjugate(real), quat_conjugate(dual));
+        }
+
+        // makes the real part a unit quaternion, and the dual part orthogonal to it
+        // returns the original magnitude of the real part
+        scalar_type normalize()
+        {
+            const auto magnitude = real.length();
+            assert(magnitude > scalar_type(0));
+            real *= scalar_type(1) / magnitude;
+            dual *= scalar_type(1) / magnitude;
+            dual -= real * real.dot(dual);
+            return magnitude;
+        }
+
+        dual_quat unit() const
+        {
+            dual_quat result(*this);
+            result.normalize();
+            return result;
+        }
+
+        constexpr quat_type rotation() const
+        {
+            return real;
+        }
+
+        constexpr vec3_type translation() const
+        {
+            const auto t = quat_multiply(dual, quat_conjugate(real)) * scalar_type(2);
+            return vec3_type(t.x, t.y, t.z);
+        }
+
+        constexpr vec3_type transform_point(const vec3_type& point) const
+        {
+            return quat_rotate(real, point) + translation();
+        }
+
+        constexpr vec3_type transform_vector(const vec3_type& vector) const
+        {
+            return quat_rotate(real, vector);
+        }
+
+        constexpr mat4_type to_matrix() const
+        {
+            auto result = quat_to_matrix(real);
+            const auto t = translation();
+            result(3, 0) = t.x;
+            result(3, 1) = t.y;
+            result(3, 2) = t.z;
+            return result;
+        }
+
+        quat_type real;
+        quat_type dual;
+    };
+} // namespace impl
+
+    using dual_quat = impl::dual_quat<float>;
+} // namespace clg
+
+#endif
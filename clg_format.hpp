@@ -0,0 +1,742 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGFORMAT_HPP
+#define CLGFORMAT_HPP
+
+#ifndef CLGRECTANGLE_HPP
+  #include "clg_rectangle.hpp"
+#endif
+#ifndef CLGMATRIX_HPP
+  #include "clg_matrix.hpp"
+#endif
+
+/*
+ *
+ * Text formatting and parsing for vectors, matrices, and rects; built on <charconv>.
+ *
+ * These write into, and read from, caller buffers. They don't allocate, or use streams. Like std::to_chars() and
+ * std::from_chars() they return the end of what was written, or read, and an error code:
+ *  std::errc::value_too_large      - the buffer is too small; its contents are unspecified
+ *  std::errc::invalid_argument     - the text isn't a vector, matrix, or rect of the right size
+ *  std::errc::result_out_of_range  - an element doesn't fit in the scalar type
+ *
+ * Layouts:
+ *  text_layout::pretty     - the same text as the std::ostream operators; vectors "( 1, 2.5, 3 )", rects
+ *                            "( 1, 2 ), ( 3, 4 )", and matrices as rows of fixed-point elements, padded into columns
+ *                            "[  1.000, -0.500 ]\n[  0.000,  1.000 ]"
+ *  text_layout::compact    - the same shapes without the spaces or padding, with the shortest text that reads back
+ *                            to the same value; vectors "(1,2.5,3)", rects "(1,2),(3,4)", matrices "[1,-0.5][0,1]"
+ *
+ * The parsers read either layout, with any amount of whitespace between the tokens. A buffer of 32 characters per
+ * element is always enough for either layout.
+ *
+ * Colors (rgb, rgba, and argb; float or uint8_t channels) have their own text formats, always in r, g, b, a order:
+ *  color_format::hex           - "#7FA0FF", or "#7FA0FF80" with alpha; also parses "#RGB" and "#RGBA"
+ *  color_format::bytes         - "127, 160, 255"
+ *  color_format::normalized    - "0.5, 0.75, 1"
+ * color_from_chars() works out the format from the text; numbers with a decimal point, or exponent, are normalized.
+ * Colors without alpha text are opaque. parse_colors() reads a whole buffer of them, one per line.
+ *
+ */
+
+namespace clg
+{
+    enum class text_layout
+    {
+        pretty,
+        compact,
+    };
+
+    namespace impl
+    {
+        inline constexpr bool is_text_space(const char c)
+        {
+            return ' ' == c || '\t' == c || '\n' == c || '\r' == c;
+        }
+
+        inline const char* skip_text_space(const char* first, const char* const last)
+        {
+            while (first != last && is_text_space(*first))
+            {
+                first++;
+            }
+            return first;
+        }
+
+        // Skips whitespace, then the expected character. Returns nullptr if it isn't there.
+        inline const char* expect_char(const char* first, const char* const last, const char expected)
+        {
+            first = skip_text_space(first, last);
+            return (first != last && expected == *first) ? first + 1 : nullptr;
+        }
+
+        inline std::to_chars_result put_chars(char* const first, char* const last, const char* const text, const size_t count)
+        {
+            if (static_cast<size_t>(last - first) < count)
+            {
+                return { last, std::errc::value_too_large };
+            }
+            std::memcpy(first, text, count);
+            return { first + count, std::errc() };
+        }
+
+        template<typename ScalarT>
+        inline std::to_chars_result put_scalar(char* const first, char* const last, const ScalarT value, const text_layout layout)
+        {
+            if constexpr (std::is_floating_point_v<ScalarT>)
+            {
+                if (text_layout::pretty == layout)
+                {
+                    return std::to_chars(first, last, value, std::chars_format::general, 6); // like the default stream format
+                }
+                return std::to_chars(first, last, value); // shortest round-trip text
+            }
+            else
+            {
+                (void)layout;
+                return std::to_chars(first, last, value);
+            }
+        }
+
+        template<typename ScalarT>
+        inline std::from_chars_result get_scalar(const char* first, const char* const last, ScalarT& value)
+        {
+            first = skip_text_space(first, last);
+            if (first != last && '+' == *first)
+            {
+                first++;
+            }
+            return std::from_chars(first, last, value);
+        }
+
+        template<typename ScalarT>
+        inline std::to_chars_result put_scalars(
+            char* first,
+            char* const last,
+            const ScalarT* const values,
+            const unsigned int count,
+            const char open,
+            const char close,
+            const text_layout layout
+            )
+        {
+            const auto pretty = text_layout::pretty == layout;
+            const char opening[] = { open, ' ' };
+            auto result = put_chars(first, last, opening, pretty ? 2 : 1);
+            for (auto i = 0u; i < count && std::errc() == result.ec; i++)
+            {
+                if (0 != i)
+                {
+                    result = put_chars(result.ptr, last, ", ", pretty ? 2 : 1);
+                    if (std::errc() != result.ec)
+                    {
+                        break;
+                    }
+                }
+                result = put_scalar(result.ptr, last, values[i], layout);
+            }
+            if (std::errc() == result.ec)
+            {
+                const char closing[] = { ' ', close };
+                result = pretty ? put_chars(result.ptr, last, closing, 2) : put_chars(result.ptr, last, &close, 1);
+            }
+            return result;
+        }
+
+        // Reads: open scalar (, scalar)* close
+        template<typename ScalarT>
+        inline std::from_chars_result get_scalars(
+            const char* first,
+            const char* const last,
+            ScalarT* const values,
+            const unsigned int count,
+            const char open,
+            const char close
+            )
+        {
+            const auto* cursor = expect_char(first, last, open);
+            for (auto i = 0u; i < count && nullptr != cursor; i++)
+            {
+                if (0 != i)
+                {
+                    cursor = expect_char(cursor, last, ',');
+                    if (nullptr == cursor)
+                    {
+                        break;
+                    }
+                }
+                const auto result = get_scalar(cursor, last, values[i]);
+                if (std::errc() != result.ec)
+                {
+                    return { first, result.ec };
+                }
+                cursor = result.ptr;
+            }
+            if (nullptr != cursor)
+            {
+                cursor = expect_char(cursor, last, close);
+            }
+            if (nullptr == cursor)
+            {
+                return { first, std::errc::invalid_argument };
+            }
+            return { cursor, std::errc() };
+        }
+    } // namespace impl
+
+    template<typename ScalarT, unsigned int Dimensions, typename VecT>
+    inline std::to_chars_result to_chars(
+        char* const first,
+        char* const last,
+        const impl::base_vec<ScalarT, Dimensions, VecT>& value,
+        const text_layout layout = text_layout::compact
+        )
+    {
+        return impl::put_scalars(first, last, value.data(), Dimensions, '(', ')', layout);
+    }
+
+    template<typename ScalarT, unsigned int Dimensions, typename VecT>
+    inline std::from_chars_result from_chars(const char* const first, const char* const last, impl::base_vec<ScalarT, Dimensions, VecT>& value)
+    {
+        ScalarT elements[Dimensions];
+        const auto result = impl::get_scalars(first, last, elements, Dimensions, '(', ')');
+        if (std::errc() == result.ec)
+        {
+            for (auto i = 0u; i < Dimensions; i++)
+            {
+                value[i] = elements[i];
+            }
+        }
+        return result;
+    }
+
+    template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+    inline std::to_chars_result to_chars(
+        char* const first,
+        char* const last,
+        const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& value,
+        const text_layout layout = text_layout::compact
+        )
+    {
+        const ScalarT location[] = { value.x(), value.y() };
+        const ScalarT extent[] = { value.width(), value.height() };
+        auto result = impl::put_scalars(first, last, location, 2, '(', ')', layout);
+        if (std::errc() == result.ec)
+        {
+            result = impl::put_chars(result.ptr, last, ", ", text_layout::pretty == layout ? 2 : 1);
+        }
+        if (std::errc() == result.ec)
+        {
+            result = impl::put_scalars(result.ptr, last, extent, 2, '(', ')', layout);
+        }
+        return result;
+    }
+
+    template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+    inline std::from_chars_result from_chars(const char* const first, const char* const last, impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& value)
+    {
+        ScalarT location[2];
+        ScalarT extent[2];
+        auto result = impl::get_scalars(first, last, location, 2, '(', ')');
+        if (std::errc() != result.ec)
+        {
+            return result;
+        }
+        const auto* const comma = impl::expect_char(result.ptr, last, ',');
+        if (nullptr == comma)
+        {
+            return { first, std::errc::invalid_argument };
+        }
+        result = impl::get_scalars(comma, last, extent, 2, '(', ')');
+        if (std::errc() != result.ec)
+        {
+            return { first, result.ec };
+        }
+        value = impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>(location[0], location[1], extent[0], extent[1]);
+        return result;
+    }
+
+    template<typename ScalarT, unsigned int Columns, unsigned int Rows>
+    inline std::to_chars_result to_chars(
+        char* const first,
+        char* const last,
+        const impl::mat<ScalarT, Columns, Rows>& value,
+        const text_layout layout = text_layout::compact
+        )
+    {
+        std::to_chars_result result{ first, std::errc() };
+        if (text_layout::compact == layout)
+        {
+            for (auto i = 0u; i < Rows && std::errc() == result.ec; i++)
+            {
+                ScalarT row[Columns];
+                for (auto j = 0u; j < Columns; j++)
+                {
+                    row[j] = value(j, i);
+                }
+                result = impl::put_scalars(result.ptr, last, row, Columns, '[', ']', layout);
+            }
+            return result;
+        }
+
+        // Matches the stream operator: fixed-point with 3 digits, right-aligned in columns wide enough for the
+        // largest magnitude.
+        constexpr int fraction_digits = 3;
+        ScalarT largest_element = ScalarT(0);
+        for (auto i = 0u; i < Columns * Rows; i++)
+        {
+            const auto element = value.data()[i];
+            if constexpr (std::is_signed_v<ScalarT>)
+            {
+                largest_element = max(largest_element, element < ScalarT(0) ? ScalarT(-element) : element);
+            }
+            else
+            {
+                largest_element = max(largest_element, element);
+            }
+        }
+
+        auto padding = fraction_digits + 3; // +3 for these characters "-0."
+        if (largest_element >= ScalarT(1000))
+        {
+            padding += 3;
+        }
+        else if (largest_element >= ScalarT(100))
+        {
+            padding += 2;
+        }
+        else if (largest_element >= ScalarT(10))
+        {
+            padding += 1;
+        }
+
+        for (auto i = 0u; i < Rows && std::errc() == result.ec; i++)
+        {
+            result = 0 == i ? impl::put_chars(result.ptr, last, "[ ", 2) : impl::put_chars(result.ptr, last, "\n[ ", 3);
+            for (auto j = 0u; j < Columns && std::errc() == result.ec; j++)
+            {
+                if (0 != j)
+                {
+                    result = impl::put_chars(result.ptr, last, ", ", 2);
+                    if (std::errc() != result.ec)
+                    {
+                        break;
+                    }
+                }
+
+                char digits[64];
+                std::to_chars_result number;
+                if constexpr (std::is_floating_point_v<ScalarT>)
+                {
+                    number = std::to_chars(digits, digits + sizeof(digits), value(j, i), std::chars_format::fixed, fraction_digits);
+                }
+                else
+                {
+                    number = std::to_chars(digits, digits + sizeof(digits), value(j, i));
+                }
+                const auto length = static_cast<int>(number.ptr - digits);
+                for (auto k = length; k < padding && std::errc() == result.ec; k++)
+                {
+                    result = impl::put_chars(result.ptr, last, " ", 1);
+                }
+                if (std::errc() == result.ec)
+                {
+                    result = impl::put_chars(result.ptr, last, digits, static_cast<size_t>(length));
+                }
+            }
+            if (std::errc() == result.ec)
+            {
+                result = impl::put_chars(result.ptr, last, " ]", 2);
+            }
+        }
+        return result;
+    }
+
+    // Reads Rows bracketed rows of Columns elements; the rows may be separated by whitespace.
+    template<typename ScalarT, unsigned int Columns, unsigned int Rows>
+    inline std::from_chars_result from_chars(const char* const first, const char* const last, impl::mat<ScalarT, Columns, Rows>& value)
+    {
+        ScalarT elements[Columns * Rows];
+        std::from_chars_result result{ first, std::errc() };
+        for (auto i = 0u; i < Rows; i++)
+        {
+            ScalarT row[Columns];
+            result = impl::get_scalars(result.ptr, last, row, Columns, '[', ']');
+            if (std::errc() != result.ec)
+            {
+                return { first, result.ec };
+            }
+            for (auto j = 0u; j < Columns; j++)
+            {
+                elements[j * Rows + i] = row[j]; // column-major
+            }
+        }
+        value = impl::mat<ScalarT, Columns, Rows>(elements);
+        return result;
+    }
+
+    enum class color_format
+    {
+        hex,
+        bytes,
+        normalized,
+    };
+
+    namespace impl
+    {
+        inline constexpr unsigned int hex_digit_value(const char c)
+        {
+            if ('0' <= c && c <= '9')
+            {
+                return static_cast<unsigned int>(c - '0');
+            }
+            if ('A' <= c && c <= 'F')
+            {
+                return static_cast<unsigned int>(c - 'A' + 10);
+            }
+            if ('a' <= c && c <= 'f')
+            {
+                return static_cast<unsigned int>(c - 'a' + 10);
+            }
+            return 16;
+        }
+
+        template<typename ScalarT>
+        inline constexpr uint8_t channel_to_byte(const ScalarT value)
+        {
+            if constexpr (std::is_floating_point_v<ScalarT>)
+            {
+                return static_cast<uint8_t>(clamp(value, ScalarT(0), ScalarT(1)) * ScalarT(255) + ScalarT(0.5));
+            }
+            else
+            {
+                return static_cast<uint8_t>(clamp<ScalarT>(value, ScalarT(0), ScalarT(255)));
+            }
+        }
+
+        template<typename ScalarT>
+        inline constexpr ScalarT byte_to_channel(const uint8_t value)
+        {
+            if constexpr (std::is_floating_point_v<ScalarT>)
+            {
+                return value / ScalarT(255);
+            }
+            else
+            {
+                return static_cast<ScalarT>(value);
+            }
+        }
+
+        template<typename ScalarT>
+        inline constexpr float channel_to_unit(const ScalarT value)
+        {
+            if constexpr (std::is_floating_point_v<ScalarT>)
+            {
+                return static_cast<float>(value);
+            }
+            else
+            {
+                return value / 255.0f;
+            }
+        }
+
+        template<typename ScalarT>
+        inline constexpr ScalarT unit_to_channel(const float value)
+        {
+            if constexpr (std::is_floating_point_v<ScalarT>)
+            {
+                return static_cast<ScalarT>(value); // NOTE: Not clamped; high dynamic range colors are allowed.
+            }
+            else
+            {
+                return static_cast<ScalarT>(channel_to_byte(value));
+            }
+        }
+
+        // Color channels in text order (r, g, b, a); as bytes or normalized floats.
+        struct color_text
+        {
+            uint8_t         bytes[4];
+            float           units[4];
+            unsigned int    count;
+            bool            normalized;
+        };
+
+        template<typename ColorT>
+        inline std::to_chars_result put_color(char* const first, char* const last, const ColorT& color, const color_format format)
+        {
+            using scalar_type = typename ColorT::scalar_type;
+            constexpr auto count = ColorT::dimension_count;
+            scalar_type channels[count] = { color.r, color.g, color.b };
+            if constexpr (4 == count)
+            {
+                channels[3] = color.a;
+            }
+
+            if (color_format::hex == format)
+            {
+                constexpr char digits[] = "0123456789ABCDEF";
+                char text[1 + 2 * count];
+                text[0] = '#';
+                for (auto i = 0u; i < count; i++)
+                {
+                    const auto value = channel_to_byte(channels[i]);
+                    text[1 + 2 * i] = digits[value >> 4];
+                    text[2 + 2 * i] = digits[value & 0xf];
+                }
+                return put_chars(first, last, text, sizeof(text));
+            }
+
+            std::to_chars_result result{ first, std::errc() };
+            for (auto i = 0u; i < count && std::errc() == result.ec; i++)
+            {
+                if (0 != i)
+                {
+                    result = put_chars(result.ptr, last, ", ", 2);
+                    if (std::errc() != result.ec)
+                    {
+                        break;
+                    }
+                }
+                if (color_format::bytes == format)
+                {
+                    result = std::to_chars(result.ptr, last, static_cast<unsigned int>(channel_to_byte(channels[i])));
+                }
+                else
+                {
+                    result = std::to_chars(result.ptr, last, channel_to_unit(channels[i]));
+                }
+            }
+            return result;
+        }
+
+        inline std::from_chars_result get_color(const char* const first, const char* const last, color_text& color)
+        {
+            const auto* cursor = skip_text_space(first, last);
+            if (cursor != last && '#' == *cursor)
+            {
+                cursor++;
+                unsigned int digits[8];
+                auto digit_count = 0u;
+                for (; cursor != last && digit_count < 8; cursor++, digit_count++)
+                {
+                    digits[digit_count] = hex_digit_value(*cursor);
+                    if (16 == digits[digit_count])
+                    {
+                        break;
+                    }
+                }
+                if (cursor != last && 16 > hex_digit_value(*cursor))
+                {
+                    return { first, std::errc::invalid_argument }; // too many digits
+                }
+
+                color.normalized = false;
+                if (3 == digit_count || 4 == digit_count)
+                {
+                    color.count = digit_count;
+                    for (auto i = 0u; i < digit_count; i++)
+                    {
+                        color.bytes[i] = static_cast<uint8_t>(digits[i] * 0x11);
+                    }
+                }
+                else if (6 == digit_count || 8 == digit_count)
+                {
+                    color.count = digit_count / 2;
+                    for (auto i = 0u; i < color.count; i++)
+                    {
+                        color.bytes[i] = static_cast<uint8_t>(digits[2 * i] << 4 | digits[2 * i + 1]);
+                    }
+                }
+                else
+                {
+                    return { first, std::errc::invalid_argument };
+                }
+                return { cursor, std::errc() };
+            }
+
+            // Channels separated by commas; optionally in parentheses, like the stream output of a vector.
+            const auto* const open = expect_char(cursor, last, '(');
+            if (nullptr != open)
+            {
+                cursor = open;
+            }
+
+            // Bytes, unless one of the channels has a decimal point or an exponent.
+            color.normalized = false;
+            const auto* end = cursor;
+            for (; end != last && '\n' != *end && ')' != *end; end++)
+            {
+                if ('.' == *end || 'e' == *end || 'E' == *end)
+                {
+                    color.normalized = true;
+                }
+            }
+
+            color.count = 0;
+            for (; color.count < 4; color.count++)
+            {
+                if (0 != color.count)
+                {
+                    const auto* const comma = expect_char(cursor, last, ',');
+                    if (nullptr == comma)
+                    {
+                        break;
+                    }
+                    cursor = comma;
+                }
+
+                std::from_chars_result result;
+                if (color.normalized)
+                {
+                    result = get_scalar(cursor, last, color.units[color.count]);
+                }
+                else
+                {
+                    unsigned int value = 0;
+                    result = get_scalar(cursor, last, value);
+                    if (std::errc() == result.ec && 255 < value)
+                    {
+                        result.ec = std::errc::result_out_of_range;
+                    }
+                    color.bytes[color.count] = static_cast<uint8_t>(value);
+                }
+                if (std::errc() != result.ec)
+                {
+                    return { first, result.ec };
+                }
+                cursor = result.ptr;
+            }
+
+            if (nullptr != open)
+            {
+                cursor = expect_char(cursor, last, ')');
+            }
+            if (nullptr == cursor || color.count < 3)
+            {
+                return { first, std::errc::invalid_argument };
+            }
+            return { cursor, std::errc() };
+        }
+
+        template<typename ColorT>
+        inline bool assign_color(const color_text& text, ColorT& color)
+        {
+            using scalar_type = typename ColorT::scalar_type;
+            constexpr auto count = ColorT::dimension_count;
+            if (text.count > count)
+            {
+                return false; // alpha can't be dropped silently
+            }
+
+            scalar_type channels[4] = {};
+            for (auto i = 0u; i < text.count; i++)
+            {
+                channels[i] = text.normalized ? unit_to_channel<scalar_type>(text.units[i]) : byte_to_channel<scalar_type>(text.bytes[i]);
+            }
+            color.r = channels[0];
+            color.g = channels[1];
+            color.b = channels[2];
+            if constexpr (4 == count)
+            {
+                color.a = 3 < text.count ? channels[3] : byte_to_channel<scalar_type>(255);
+            }
+            return true;
+        }
+
+        template<typename ColorT>
+        inline std::from_chars_result parse_color(const char* const first, const char* const last, ColorT& color)
+        {
+            color_text text;
+            auto result = get_color(first, last, text);
+            if (std::errc() == result.ec && !assign_color(text, color))
+            {
+                result = { first, std::errc::invalid_argument };
+            }
+            return result;
+        }
+    } // namespace impl
+
+    template<typename ScalarT>
+    inline std::to_chars_result color_to_chars(char* const first, char* const last, const impl::rgb<ScalarT>& color, const color_format format = color_format::hex)
+    {
+        return impl::put_color(first, last, color, format);
+    }
+
+    template<typename ScalarT>
+    inline std::to_chars_result color_to_chars(char* const first, char* const last, const impl::rgba<ScalarT>& color, const color_format format = color_format::hex)
+    {
+        return impl::put_color(first, last, color, format);
+    }
+
+    template<typename ScalarT>
+    inline std::to_chars_result color_to_chars(char* const first, char* const last, const impl::argb<ScalarT>& color, const color_format format = color_format::hex)
+    {
+        return impl::put_color(first, last, color, format);
+    }
+
+    template<typename ScalarT>
+    inline std::from_chars_result color_from_chars(const char* const first, const char* const last, impl::rgb<ScalarT>& color)
+    {
+        return impl::parse_color(first, last, color);
+    }
+
+    template<typename ScalarT>
+    inline std::from_chars_result color_from_chars(const char* const first, const char* const last, impl::rgba<ScalarT>& color)
+    {
+        return impl::parse_color(first, last, color);
+    }
+
+    template<typename ScalarT>
+    inline std::from_chars_result color_from_chars(const char* const first, const char* const last, impl::argb<ScalarT>& color)
+    {
+        return impl::parse_color(first, last, color);
+    }
+
+    struct parse_colors_result
+    {
+        const char* ptr;    // the start of the line that failed, or where parsing stopped
+        size_t      count;  // of colors parsed
+        std::errc   ec;
+    };
+
+    // Parses one color per line, in any of the color formats, skipping blank lines. Stops at the first line that
+    // isn't a color (with its error), or when the colors are full.
+    template<typename ColorT>
+    inline parse_colors_result parse_colors(const char* first, const char* const last, ColorT* const colors, const size_t capacity)
+    {
+        assert(nullptr != colors || 0 == capacity);
+        parse_colors_result result{ first, 0, std::errc() };
+        while (result.count < capacity)
+        {
+            first = impl::skip_text_space(first, last);
+            result.ptr = first;
+            if (first == last)
+            {
+                break;
+            }
+
+            const auto parsed = color_from_chars(first, last, colors[result.count]);
+            auto end = parsed.ptr;
+            while (end != last && ('\n' != *end && impl::is_text_space(*end)))
+            {
+                end++;
+            }
+            if (std::errc() != parsed.ec || (end != last && '\n' != *end))
+            {
+                result.ec = std::errc() != parsed.ec ? parsed.ec : std::errc::invalid_argument;
+                return result;
+            }
+            result.count++;
+            first = end;
+        }
+        result.ptr = impl::skip_text_space(first, last);
+        return result;
+    }
+} // namespace clg
+
+#endif
@@ -0,0 +1,409 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGFRUSTUM_HPP
+#define CLGFRUSTUM_HPP
+
+#ifndef CLGMATRIX_HPP
+  #include "clg_matrix.hpp"
+#endif
+
+/*
+ *
+ * View frustum planes, extracted from a projection or view-projection matrix (Gribb & Hartmann), and a culling cache
+ * for static bounding spheres under a slowly moving camera.
+ *
+ * Each plane is a vec4 ( normal, distance ), normalized, with the normal pointing into the frustum; so a point p is
+ * inside it when dot(normal, p) + distance >= 0. An infinite far plane, which has no normal, becomes a plane that
+ * everything is inside.
+ *
+ * The cache remembers each sphere's last result: whether it's visible, which planes it's fully inside (its plane mask,
+ * so callers can skip clipping), and how far the planes could move before that result could change. Every frame it
+ * adds up a bound on how far the camera moved the planes near each sphere; until that reaches the sphere's margin, the
+ * old result stands without testing the planes. The results are also bounded per block of 64 spheres, so a block that
+ * can't have changed is skipped without reading its spheres at all; so order the spheres spatially (by grid cell, for
+ * instance), keeping neighbors in the same blocks.
+ *
+ * Example:
+ *  clg::culling_cache culling;
+ *  culling.build(bounding_spheres, object_count);                      // vec4( center, radius ), static
+ *  ...
+ *  const auto view = clg::frustum_from_matrix_gl(projection * camera);
+ *  culling.cull(view, visible_bits);                                   // one bit per object
+ *  culling.statistics().hit_rate();                                    // share of objects that weren't retested
+ *
+ */
+
+namespace clg
+{
+    class frustum
+    {
+    public:
+        enum plane_index : unsigned int
+        {
+            left_plane,
+            right_plane,
+            bottom_plane,
+            top_plane,
+            near_plane,
+            far_plane,
+            plane_count
+        };
+
+        // The planes are each normalized here; and any degenerate plane (an infinite far plane) contains everything.
+        explicit frustum(const vec4 (&planes)[plane_count])
+        {
+            for (auto i = 0u; i < plane_count; i++)
+            {
+                const auto length = vec3(planes[i].x, planes[i].y, planes[i].z).length();
+                _planes[i] = 0.0f < length ? planes[i] / length : vec4(0.0f, 0.0f, 0.0f, std::numeric_limits<float>::max());
+            }
+        }
+
+        const vec4& plane(const unsigned int index) const
+        {
+            assert(index < plane_count);
+            return _planes[index];
+        }
+
+        // Gets the signed distance from a plane to a point; positive is inside.
+        float distance(const unsigned int index, const vec3& point) const
+        {
+            const auto& p = plane(index);
+            return p.x * point.x + p.y * point.y + p.z * point.z + p.w;
+        }
+
+        bool contains(const vec3& point) const
+        {
+            for (auto i = 0u; i < plane_count; i++)
+            {
+                if (distance(i, point) < 0.0f)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Spheres that only touch the frustum count.
+        bool intersects(const vec3& center, const float radius) const
+        {
+            for (auto i = 0u; i < plane_count; i++)
+            {
+                if (distance(i, center) < -radius)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        vec4 _planes[plane_count];
+    };
+
+    namespace impl
+    {
+        // The rows of a matrix; clip space tests like -w <= x <= w become row 3 + row 0 >= 0, and so on.
+        inline vec4 matrix_row(const mat4& matrix, const unsigned int row)
+        {
+            return vec4(matrix(0, row), matrix(1, row), matrix(2, row), matrix(3, row));
+        }
+    } // namespace impl
+
+    // Gets the frustum of an OpenGL projection, or view-projection, matrix; -w <= z <= w.
+    inline frustum frustum_from_matrix_gl(const mat4& view_projection)
+    {
+        const auto x = impl::matrix_row(view_projection, 0);
+        const auto y = impl::matrix_row(view_projection, 1);
+        const auto z = impl::matrix_row(view_projection, 2);
+        const auto w = impl::matrix_row(view_projection, 3);
+        const vec4 planes[] = { w + x, w - x, w + y, w - y, w + z, w - z };
+        return frustum(planes);
+    }
+
+    // Gets the frustum of a DirectX projection, or view-projection, matrix; 0 <= z <= w.
+    inline frustum frustum_from_matrix_dx(const mat4& view_projection)
+    {
+        const auto x = impl::matrix_row(view_projection, 0);
+        const auto y = impl::matrix_row(view_projection, 1);
+        const auto z = impl::matrix_row(view_projection, 2);
+        const auto w = impl::matrix_row(view_projection, 3);
+        const vec4 planes[] = { w + x, w - x, w + y, w - y, z, w - z };
+        return frustum(planes);
+    }
+
+    struct culling_statistics
+    {
+        size_t objects;     // spheres culled by the last cull()
+        size_t tested;      // spheres whose cached result had expired, and were tested against the planes
+        size_t reused;      // spheres that kept their cached result
+        size_t visible;
+
+        double hit_rate() const
+        {
+            return 0 != objects ? static_cast<double>(reused) / static_cast<double>(objects) : 0.0;
+        }
+    };
+
+    // Caches the frustum culling results of static bounding spheres between frames.
+    class culling_cache
+    {
+    public:
+        using mask_type = uint64_t;
+        static constexpr size_t mask_bits = 64;
+
+        // the plane mask bits; bit i is set when the sphere is fully inside plane i
+        static constexpr uint8_t all_planes = (1u << frustum::plane_count) - 1;
+
+        // Takes vec4( center, radius ) bounding spheres; forgetting any cached results.
+        void build(const vec4* const spheres, const size_t count)
+        {
+            assert(nullptr != spheres || 0 == count);
+            _spheres.assign(spheres, spheres + count);
+            _reach.resize(count);
+            _expiry.assign(count, -std::numeric_limits<float>::infinity());
+            _states.assign(count, uint8_t(0));
+            _visible.assign((count + mask_bits - 1) / mask_bits, mask_type(0));
+            _block_reach.assign(_visible.size(), 0.0f);
+            _block_expiry.assign(_visible.size(), -std::numeric_limits<float>::infinity());
+
+            // Plane movement is bounded per unit of distance from the origin; see cull().
+            _rebase_drift = 0.0;
+            for (auto i = size_t(0); i < count; i++)
+            {
+                _reach[i] = vec3(spheres[i].x, spheres[i].y, spheres[i].z).length();
+                _block_reach[i / mask_bits] = std::max(_block_reach[i / mask_bits], _reach[i]);
+                _rebase_drift = std::max(_rebase_drift, static_cast<double>(_reach[i]) + spheres[i].w);
+            }
+            _has_planes = false;
+            _statistics = culling_statistics{ count, 0, 0, 0 };
+        }
+
+        // Forgets the cached results, so the next cull() tests every sphere.
+        void invalidate()
+        {
+            _expiry.assign(_expiry.size(), -std::numeric_limits<float>::infinity());
+            _block_expiry.assign(_block_expiry.size(), -std::numeric_limits<float>::infinity());
+            _has_planes = false;
+        }
+
+        // Sets bit i of visible ((count + 63) / 64 words) for each sphere that intersects the frustum.
+        // Returns the number of visible spheres.
+        size_t cull(const frustum& view, mask_type* const visible)
+        {
+            assert(nullptr != visible || _spheres.empty());
+            CLG_INSTRUMENT_SCOPE("culling_cache::cull", _spheres.size());
+            advance(view);
+
+            // The drift at each sphere is _drift_constant + _drift_per_distance * reach. Rounding both up by a few
+            // epsilon keeps the float sum at or above its exact value, so the check is conservative and vectorizes.
+            const auto guard = 1.0 + 4.0 * std::numeric_limits<float>::epsilon();
+            const auto constant = round_up_to_float(_drift_constant * guard);
+            const auto per_distance = round_up_to_float(_drift_per_distance * guard);
+
+            const auto count = _spheres.size();
+            auto tested = size_t(0);
+            auto hits = size_t(0);
+            for (auto block = size_t(0); block < count; block += mask_bits)
+            {
+                const auto block_count = std::min(count - block, mask_bits);
+                const auto b = block / mask_bits;
+
+                // Skip the whole block, without touching its spheres, while the farthest one's drift is under the
+                // soonest expiry.
+                if (_drift_constant + _drift_per_distance * _block_reach[b] >= _block_expiry[b])
+                {
+                    uint32_t stale[mask_bits];
+                    const auto stale_count = find_stale(_reach.data() + block, _expiry.data() + block, block_count, constant, per_distance, stale);
+                    for (auto j = size_t(0); j < block_count && 0 != stale_count; j++)
+                    {
+                        if (0 != stale[j])
+                        {
+                            const auto hit = test(view, block + j);
+                            _visible[b] = (_visible[b] & ~(mask_type(1) << j)) | (mask_type(hit) << j);
+                        }
+                    }
+                    tested += stale_count;
+                    _block_expiry[b] = *std::min_element(_expiry.data() + block, _expiry.data() + block + block_count);
+                }
+                visible[b] = _visible[b];
+                hits += population_count(_visible[b]);
+            }
+
+            _statistics = culling_statistics{ count, tested, count - tested, hits };
+            return hits;
+        }
+
+        size_t size() const
+        {
+            return _spheres.size();
+        }
+
+        // Gets the planes sphere i was fully inside at its last test; zero if it was culled.
+        uint8_t plane_mask(const size_t index) const
+        {
+            assert(index < _states.size());
+            return 0 != (_states[index] & culled_flag) ? uint8_t(0) : _states[index];
+        }
+
+        bool visible(const size_t index) const
+        {
+            assert(index < _states.size());
+            return 0 == (_states[index] & culled_flag);
+        }
+
+        // the results of the last cull()
+        const culling_statistics& statistics() const
+        {
+            return _statistics;
+        }
+
+    private:
+        // A visible state is its plane mask.
+        static constexpr uint8_t culled_flag = 0x80u;
+
+        // Adds up how far the planes could have moved since the last frame.
+        void advance(const frustum& view)
+        {
+            if (_has_planes)
+            {
+                // The change in a normalized plane's distance to p is ((n' - n) . p) + (d' - d); so it's bounded by
+                // |n' - n| * |p| + |d' - d|, and the worst plane bounds them all.
+                auto constant = 0.0;
+                auto per_distance = 0.0;
+                for (auto i = 0u; i < frustum::plane_count; i++)
+                {
+                    const auto& now = view.plane(i);
+                    const auto& then = _planes[i];
+                    constant = std::max(constant, static_cast<double>(std::abs(now.w - then.w)));
+                    per_distance = std::max(per_distance, static_cast<double>(vec3(now.x - then.x, now.y - then.y, now.z - then.z).length()));
+                }
+                _drift_constant += constant;
+                _drift_per_distance += per_distance;
+
+                // Once the planes could have moved across the whole scene, few results would survive anyway; so start
+                // over, before the drift outgrows a float's precision next to the margins.
+                if (_drift_constant + _drift_per_distance * _rebase_drift > _rebase_drift)
+                {
+                    _expiry.assign(_expiry.size(), -std::numeric_limits<float>::infinity());
+                    _block_expiry.assign(_block_expiry.size(), -std::numeric_limits<float>::infinity());
+                    _drift_constant = 0.0;
+                    _drift_per_distance = 0.0;
+                }
+            }
+
+            for (auto i = 0u; i < frustum::plane_count; i++)
+            {
+                _planes[i] = view.plane(i);
+            }
+            _has_planes = true;
+        }
+
+        static float round_up_to_float(const double value)
+        {
+            auto rounded = static_cast<float>(value);
+            if (static_cast<double>(rounded) < value)
+            {
+                rounded = std::nextafter(rounded, std::numeric_limits<float>::infinity());
+            }
+            return rounded;
+        }
+
+        // Flags the spheres whose results may have expired; returns how many.
+        static uint32_t find_stale(
+            const float* const reach,
+            const float* const expiry,
+            const size_t count,
+            const float constant,
+            const float per_distance,
+            uint32_t* const stale
+            )
+        {
+            auto stale_count = 0u;
+            for (auto i = size_t(0); i < count; i++)
+            {
+                stale[i] = constant + per_distance * reach[i] < expiry[i] ? 0u : 1u;
+                stale_count += stale[i];
+            }
+            return stale_count;
+        }
+
+        // Tests a sphere against the planes, and caches the result; returns whether it's visible.
+        bool test(const frustum& view, const size_t index)
+        {
+            const auto& sphere = _spheres[index];
+            const vec3 center(sphere.x, sphere.y, sphere.z);
+            const auto radius = sphere.w;
+
+            // A culled sphere keeps the plane it's farthest outside of; which gives it the most room to stay culled.
+            auto mask = uint8_t(0);
+            auto margin = std::numeric_limits<float>::max();
+            auto culling_plane = static_cast<unsigned int>(frustum::plane_count);
+            auto culling_margin = 0.0f;
+            for (auto i = 0u; i < frustum::plane_count; i++)
+            {
+                const auto distance = view.distance(i, center);
+                if (distance < -radius)
+                {
+                    if (-radius - distance > culling_margin || frustum::plane_count == culling_plane)
+                    {
+                        culling_plane = i;
+                        culling_margin = -radius - distance;
+                    }
+                }
+                else if (distance >= radius)
+                {
+                    mask |= uint8_t(1u << i);
+                    margin = std::min(margin, distance - radius);
+                }
+                else
+                {
+                    margin = std::min(margin, std::min(distance + radius, radius - distance));
+                }
+            }
+
+            if (frustum::plane_count != culling_plane)
+            {
+                keep(index, culled_flag, culling_margin);
+                return false;
+            }
+            keep(index, mask, margin);
+            return true;
+        }
+
+        // Caches a result, valid while the drift at the sphere stays under margin.
+        void keep(const size_t index, const uint8_t state, const float margin)
+        {
+            _states[index] = state;
+
+            // Round down, so a rounded expiry never outlasts the margin.
+            const auto expiry = _drift_constant + _drift_per_distance * _reach[index] + margin;
+            auto rounded = static_cast<float>(expiry);
+            if (static_cast<double>(rounded) > expiry)
+            {
+                rounded = std::nextafter(rounded, -std::numeric_limits<float>::infinity());
+            }
+            _expiry[index] = rounded;
+        }
+
+        std::vector<vec4>       _spheres;
+        std::vector<float>      _reach;         // distance of each sphere's center from the origin
+        std::vector<float>      _expiry;        // drift at which each cached result may have changed
+        std::vector<uint8_t>    _states;
+        std::vector<mask_type>  _visible;       // the cached results, as cull() returns them
+        std::vector<float>      _block_reach;   // the farthest reach in each block of mask_bits spheres
+        std::vector<float>      _block_expiry;  // the soonest expiry in each block
+        vec4                    _planes[frustum::plane_count];
+        double                  _drift_constant = 0.0;
+        double                  _drift_per_distance = 0.0;
+        double                  _rebase_drift = 0.0;
+        bool                    _has_planes = false;
+        culling_statistics      _statistics = {};
+    };
+} // namespace clg
+
+#endif
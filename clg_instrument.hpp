@@ -0,0 +1,307 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGINSTRUMENT_HPP
+#define CLGINSTRUMENT_HPP
+
+/*
+ *
+ * Opt-in instrumentation, for finding out which library operations dominate a slow frame. It's off unless
+ * CLG_INSTRUMENT is defined before the first clg header; then the hooks below expand to nothing, so release builds pay
+ * nothing for them. With it on, include <atomic>, <chrono>, <ostream>, and <vector> before the clg headers.
+ *
+ *  CLG_INSTRUMENT_COUNT(op)            counts one call of an instrument_op; in the matrix, vector, and rect operations
+ *  CLG_INSTRUMENT_SCOPE(name, count)   times the rest of a scope, as one trace event; in the batch kernels
+ *
+ * The counters and events are thread local, so the hooks never lock or share cache lines. instrument_capture() gets a
+ * snapshot of the calling thread's, and instrument_reset() clears them; call both once a frame from each thread of
+ * interest. Snapshots export as JSON, or as a Chrome trace (chrome://tracing, Perfetto) with one row per thread.
+ *
+ * Example:
+ *  #define CLG_INSTRUMENT
+ *  ...
+ *  const auto frame = clg::instrument_capture();
+ *  clg::instrument_reset();
+ *  if (frame_was_slow)
+ *  {
+ *      clg::write_chrome_trace(trace_file, &frame, 1);
+ *  }
+ *
+ */
+
+#ifdef CLG_INSTRUMENT
+
+// The counted operations are constexpr; skip the count while they're being constant evaluated, so they still can be.
+#define CLG_INSTRUMENT_COUNT(op) (__builtin_is_constant_evaluated() ? (void)0 : ::clg::instrument_count(::clg::instrument_op::op))
+#define CLG_INSTRUMENT_SCOPE(name, count) const ::clg::instrument_scope clg_instrument_scope_(name, count)
+
+namespace clg
+{
+    enum class instrument_op : unsigned int
+    {
+        matrix_multiply,
+        vector_normalize,
+        rect_contains,
+        rect_overlaps,
+        rect_intersect,
+        count
+    };
+
+    inline const char* instrument_op_name(const instrument_op op)
+    {
+        static const char* const names[] = { "matrix_multiply", "vector_normalize", "rect_contains", "rect_overlaps", "rect_intersect" };
+        static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(instrument_op::count), "missing instrument_op name");
+        return names[static_cast<size_t>(op)];
+    }
+
+    // One timed run of a batch kernel.
+    struct instrument_event
+    {
+        const char* name;           // a string literal
+        int64_t     start;          // nanoseconds since the steady clock's epoch
+        int64_t     duration;       // nanoseconds
+        size_t      count;          // elements processed
+    };
+
+    // All the timed runs of one batch kernel.
+    struct instrument_kernel
+    {
+        const char* name;
+        size_t      calls;
+        size_t      count;          // elements processed
+        int64_t     duration;       // nanoseconds
+    };
+
+    struct instrument_snapshot
+    {
+        uint32_t                        thread;             // numbered in order of each thread's first instrumented call
+        uint64_t                        op_counts[static_cast<size_t>(instrument_op::count)];
+        std::vector<instrument_kernel>  kernels;
+        std::vector<instrument_event>   events;             // oldest first
+        size_t                          dropped_events;     // runs after events filled up; still in kernels
+    };
+
+namespace impl
+{
+    class instrument_state
+    {
+    public:
+        static constexpr size_t max_events = 65536;
+
+        instrument_state()
+            : _thread(next_thread()++) { }
+
+        void count(const instrument_op op)
+        {
+            _op_counts[static_cast<size_t>(op)]++;
+        }
+
+        void record(const instrument_event& event)
+        {
+            // Kernel names are string literals; comparing their addresses is enough, and there are only a few.
+            auto kernel = _kernels.begin();
+            while (kernel != _kernels.end() && kernel->name != event.name)
+            {
+                ++kernel;
+            }
+            if (kernel == _kernels.end())
+            {
+                _kernels.push_back(instrument_kernel{ event.name, 0, 0, 0 });
+                kernel = _kernels.end() - 1;
+            }
+            kernel->calls++;
+            kernel->count += event.count;
+            kernel->duration += event.duration;
+
+            if (_events.size() < max_events)
+            {
+                _events.push_back(event);
+            }
+            else
+            {
+                _dropped_events++;
+            }
+        }
+
+        instrument_snapshot capture() const
+        {
+            instrument_snapshot result{ _thread, {}, _kernels, _events, _dropped_events };
+            for (auto i = size_t(0); i < static_cast<size_t>(instrument_op::count); i++)
+            {
+                result.op_counts[i] = _op_counts[i];
+            }
+            return result;
+        }
+
+        void reset()
+        {
+            for (auto& op_count : _op_counts)
+            {
+                op_count = 0;
+            }
+            _kernels.clear();
+            _events.clear();
+            _dropped_events = 0;
+        }
+
+        static instrument_state& current()
+        {
+            static thread_local instrument_state state;
+            return state;
+        }
+
+    private:
+        static std::atomic<uint32_t>& next_thread()
+        {
+            static std::atomic<uint32_t> thread{ 0 };
+            return thread;
+        }
+
+        uint32_t                        _thread;
+        uint64_t                        _op_counts[static_cast<size_t>(instrument_op::count)] = {};
+        std::vector<instrument_kernel>  _kernels;
+        std::vector<instrument_event>   _events;
+        size_t                          _dropped_events = 0;
+    };
+
+    inline int64_t instrument_now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    inline void write_json_string(std::ostream& stream, const char* text)
+    {
+        // The names are all identifiers, but escape them anyway.
+        stream << '"';
+        for (; '\0' != *text; text++)
+        {
+            if ('"' == *text || '\\' == *text)
+            {
+                stream << '\\';
+            }
+            stream << *text;
+        }
+        stream << '"';
+    }
+} // namespace impl
+
+    inline void instrument_count(const instrument_op op)
+    {
+        impl::instrument_state::current().count(op);
+    }
+
+    // Times its own lifetime, as a run of the named kernel over count elements.
+    class instrument_scope
+    {
+    public:
+        instrument_scope(const char* const name, const size_t count)
+            : _name(name)
+            , _count(count)
+            , _start(impl::instrument_now()) { }
+
+        instrument_scope(const instrument_scope&) = delete;
+        instrument_scope& operator =(const instrument_scope&) = delete;
+
+        ~instrument_scope()
+        {
+            impl::instrument_state::current().record(instrument_event{ _name, _start, impl::instrument_now() - _start, _count });
+        }
+
+    private:
+        const char* _name;
+        size_t      _count;
+        int64_t     _start;
+    };
+
+    // Gets a copy of the calling thread's counters and events.
+    inline instrument_snapshot instrument_capture()
+    {
+        return impl::instrument_state::current().capture();
+    }
+
+    // Clears the calling thread's counters and events.
+    inline void instrument_reset()
+    {
+        impl::instrument_state::current().reset();
+    }
+
+    // Writes a snapshot as a JSON object; with its op counts, and each kernel's totals, but not the individual events.
+    inline void write_json(std::ostream& stream, const instrument_snapshot& snapshot)
+    {
+        stream << "{\"thread\":" << snapshot.thread << ",\"ops\":{";
+        for (auto i = size_t(0); i < static_cast<size_t>(instrument_op::count); i++)
+        {
+            stream << (0 == i ? "" : ",");
+            impl::write_json_string(stream, instrument_op_name(static_cast<instrument_op>(i)));
+            stream << ':' << snapshot.op_counts[i];
+        }
+        stream << "},\"kernels\":[";
+        for (auto i = size_t(0); i < snapshot.kernels.size(); i++)
+        {
+            const auto& kernel = snapshot.kernels[i];
+            stream << (0 == i ? "{" : ",{") << "\"name\":";
+            impl::write_json_string(stream, kernel.name);
+            stream << ",\"calls\":" << kernel.calls << ",\"count\":" << kernel.count << ",\"ns\":" << kernel.duration << '}';
+        }
+        stream << "],\"dropped_events\":" << snapshot.dropped_events << '}';
+    }
+
+    // Writes snapshots, from one or more threads, in the Chrome trace event format. The kernel runs are complete ("X")
+    // events, and the op counts are counter ("C") events at the end of each thread's events.
+    inline void write_chrome_trace(std::ostream& stream, const instrument_snapshot* const snapshots, const size_t count)
+    {
+        assert(nullptr != snapshots || 0 == count);
+
+        // Chrome traces are in microseconds; start them at the earliest event.
+        auto origin = int64_t(0);
+        auto first = true;
+        for (auto i = size_t(0); i < count; i++)
+        {
+            for (const auto& event : snapshots[i].events)
+            {
+                origin = first || event.start < origin ? event.start : origin;
+                first = false;
+            }
+        }
+
+        const auto micro = [](const int64_t nanoseconds) { return static_cast<double>(nanoseconds) / 1000.0; };
+        const char* separator = "";
+        stream << "{\"traceEvents\":[";
+        for (auto i = size_t(0); i < count; i++)
+        {
+            auto end = int64_t(0);
+            for (const auto& event : snapshots[i].events)
+            {
+                stream << separator << "{\"name\":";
+                impl::write_json_string(stream, event.name);
+                stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << snapshots[i].thread << ",\"ts\":" << micro(event.start - origin)
+                    << ",\"dur\":" << micro(event.duration) << ",\"args\":{\"count\":" << event.count << "}}";
+                separator = ",";
+                end = std::max(end, event.start + event.duration - origin);
+            }
+
+            stream << separator << "{\"name\":\"clg ops\",\"ph\":\"C\",\"pid\":0,\"tid\":" << snapshots[i].thread << ",\"ts\":" << micro(end) << ",\"args\":{";
+            for (auto j = size_t(0); j < static_cast<size_t>(instrument_op::count); j++)
+            {
+                stream << (0 == j ? "" : ",");
+                impl::write_json_string(stream, instrument_op_name(static_cast<instrument_op>(j)));
+                stream << ':' << snapshots[i].op_counts[j];
+            }
+            stream << "}}";
+            separator = ",";
+        }
+        stream << "],\"displayTimeUnit\":\"ns\"}";
+    }
+} // namespace clg
+
+#else
+
+#define CLG_INSTRUMENT_COUNT(op) ((void)0)
+#define CLG_INSTRUMENT_SCOPE(name, count) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,610 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGLINALG_HPP
+#define CLGLINALG_HPP
+
+#ifndef CLGMATRIX_HPP
+  #include "clg_matrix.hpp"
+#endif
+
+/*
+ *
+ * Dense solvers for small, compile-time sized, matrices; like the 6x6 and 8x8 systems of calibration and fitting.
+ *
+ *  lu_decompose()          - LU with partial pivoting; for solve(), determinant(), and inverse()
+ *  qr_decompose()          - Householder QR of a square, or tall, matrix; qr_solve() gives the least-squares solution
+ *  cholesky_decompose()    - for symmetric positive-definite matrices, like normal equations; no pivoting needed
+ *  symmetric_eigen()       - Jacobi eigen-decomposition of symmetric 3x3 matrices; like inertia tensors, or covariance
+ *  svd()                   - 3x3 singular value decomposition (from the eigenvectors of transpose(A) * A, then Givens QR)
+ *  polar_decompose()       - splits a 3x3 into rotation * stretch
+ *
+ * Every loop bound is a template parameter, so the compiler can fully unroll and vectorize them; and nothing
+ * allocates. The factorizations loop down columns, matching the column-major storage of mat.
+ *
+ * Decompositions return false, instead of producing infinities, when the matrix is singular (or, for Cholesky, not
+ * positive-definite) to working precision.
+ *
+ * Example:
+ *  clg::impl::vec<float, 6> x;
+ *  if (clg::solve(a, b, x)) { ... }                // one-off
+ *
+ *  clg::lu_factors<float, 6> factors;              // many right-hand sides
+ *  if (clg::lu_decompose(a, factors)) { x = clg::lu_solve(factors, b); }
+ *
+ */
+
+namespace clg
+{
+    // P * A = L * U; with the unit lower triangle L, and the upper triangle U, packed into one matrix.
+    template<typename ScalarT, unsigned int Size>
+    struct lu_factors
+    {
+        impl::mat<ScalarT, Size, Size> lu;
+        unsigned int pivots[Size];  // row i of P * A is row pivots[i] of A
+        ScalarT parity;             // -1 after an odd number of row swaps
+    };
+
+    // A = Q * R; with R above the diagonal and the Householder vectors, that make Q, on and below it.
+    template<typename ScalarT, unsigned int Columns, unsigned int Rows>
+    struct qr_factors
+    {
+        impl::mat<ScalarT, Columns, Rows> qr;
+        ScalarT r_diagonal[Columns];
+    };
+
+    namespace impl
+    {
+        // A pivot is treated as zero when it's this small, relative to the largest pivot before it.
+        template<typename ScalarT, unsigned int Size>
+        inline constexpr ScalarT pivot_tolerance(const ScalarT largest_pivot)
+        {
+            return largest_pivot * std::numeric_limits<ScalarT>::epsilon() * static_cast<ScalarT>(Size);
+        }
+    } // namespace impl
+
+    template<typename ScalarT, unsigned int Size>
+    inline bool lu_decompose(const impl::mat<ScalarT, Size, Size>& a, lu_factors<ScalarT, Size>& factors)
+    {
+        auto& lu = factors.lu;
+        lu = a;
+        factors.parity = ScalarT(1);
+        ScalarT largest_pivot(0);
+        for (auto i = 0u; i < Size; i++)
+        {
+            factors.pivots[i] = i;
+        }
+
+        for (auto k = 0u; k < Size; k++)
+        {
+            auto pivot = k;
+            for (auto i = k + 1; i < Size; i++)
+            {
+                if (std::abs(lu(k, i)) > std::abs(lu(k, pivot)))
+                {
+                    pivot = i;
+                }
+            }
+            const auto magnitude = std::abs(lu(k, pivot));
+            if (!(magnitude > impl::pivot_tolerance<ScalarT, Size>(largest_pivot)) || ScalarT(0) == magnitude)
+            {
+                return false;
+            }
+            largest_pivot = std::max(largest_pivot, magnitude);
+
+            if (pivot != k)
+            {
+                for (auto j = 0u; j < Size; j++)
+                {
+                    std::swap(lu(j, k), lu(j, pivot));
+                }
+                std::swap(factors.pivots[k], factors.pivots[pivot]);
+                factors.parity = -factors.parity;
+            }
+
+            const auto inverse_pivot = ScalarT(1) / lu(k, k);
+            for (auto i = k + 1; i < Size; i++)
+            {
+                lu(k, i) *= inverse_pivot;
+            }
+            for (auto j = k + 1; j < Size; j++)
+            {
+                const auto u = lu(j, k);
+                for (auto i = k + 1; i < Size; i++)
+                {
+                    lu(j, i) -= lu(k, i) * u;
+                }
+            }
+        }
+        return true;
+    }
+
+    template<typename ScalarT, unsigned int Size>
+    inline impl::vec<ScalarT, Size> lu_solve(const lu_factors<ScalarT, Size>& factors, const impl::vec<ScalarT, Size>& b)
+    {
+        const auto& lu = factors.lu;
+        impl::vec<ScalarT, Size> x;
+        for (auto i = 0u; i < Size; i++)
+        {
+            x[i] = b[factors.pivots[i]];
+        }
+
+        // L * y = P * b
+        for (auto k = 0u; k < Size; k++)
+        {
+            for (auto i = k + 1; i < Size; i++)
+            {
+                x[i] -= lu(k, i) * x[k];
+            }
+        }
+
+        // U * x = y
+        for (auto k = Size; k-- > 0;)
+        {
+            x[k] /= lu(k, k);
+            for (auto i = 0u; i < k; i++)
+            {
+                x[i] -= lu(k, i) * x[k];
+            }
+        }
+        return x;
+    }
+
+    template<typename ScalarT, unsigned int Size>
+    inline ScalarT determinant(const lu_factors<ScalarT, Size>& factors)
+    {
+        auto result = factors.parity;
+        for (auto i = 0u; i < Size; i++)
+        {
+            result *= factors.lu(i, i);
+        }
+        return result;
+    }
+
+    template<typename ScalarT, unsigned int Size>
+    inline impl::mat<ScalarT, Size, Size> inverse(const lu_factors<ScalarT, Size>& factors)
+    {
+        impl::mat<ScalarT, Size, Size> result(ScalarT(0));
+        for (auto j = 0u; j < Size; j++)
+        {
+            impl::vec<ScalarT, Size> column(ScalarT(0));
+            column[j] = ScalarT(1);
+            column = lu_solve(factors, column);
+            for (auto i = 0u; i < Size; i++)
+            {
+                result(j, i) = column[i];
+            }
+        }
+        return result;
+    }
+
+    // Solves A * x = b; returns false when A is singular.
+    template<typename ScalarT, unsigned int Size>
+    inline bool solve(const impl::mat<ScalarT, Size, Size>& a, const impl::vec<ScalarT, Size>& b, impl::vec<ScalarT, Size>& x)
+    {
+        lu_factors<ScalarT, Size> factors;
+        if (!lu_decompose(a, factors))
+        {
+            return false;
+        }
+        x = lu_solve(factors, b);
+        return true;
+    }
+
+    // Returns false when the columns of A aren't linearly independent.
+    template<typename ScalarT, unsigned int Columns, unsigned int Rows>
+    inline bool qr_decompose(const impl::mat<ScalarT, Columns, Rows>& a, qr_factors<ScalarT, Columns, Rows>& factors)
+    {
+        static_assert(Rows >= Columns, "QR needs at least as many rows as columns");
+        auto& qr = factors.qr;
+        qr = a;
+        auto full_rank = true;
+        ScalarT largest_norm(0);
+        for (auto k = 0u; k < Columns; k++)
+        {
+            ScalarT norm(0);
+            for (auto i = k; i < Rows; i++)
+            {
+                norm += qr(k, i) * qr(k, i);
+            }
+            norm = std::sqrt(norm);
+
+            if (norm > impl::pivot_tolerance<ScalarT, Rows>(largest_norm) && ScalarT(0) != norm)
+            {
+                largest_norm = std::max(largest_norm, norm);
+
+                // Reflect column k onto the diagonal; the reflection goes away from the sign of the diagonal.
+                if (qr(k, k) < ScalarT(0))
+                {
+                    norm = -norm;
+                }
+                for (auto i = k; i < Rows; i++)
+                {
+                    qr(k, i) /= norm;
+                }
+                qr(k, k) += ScalarT(1);
+
+                for (auto j = k + 1; j < Columns; j++)
+                {
+                    ScalarT s(0);
+                    for (auto i = k; i < Rows; i++)
+                    {
+                        s += qr(k, i) * qr(j, i);
+                    }
+                    s = -s / qr(k, k);
+                    for (auto i = k; i < Rows; i++)
+                    {
+                        qr(j, i) += s * qr(k, i);
+                    }
+                }
+            }
+            else
+            {
+                norm = ScalarT(0);
+                full_rank = false;
+            }
+            factors.r_diagonal[k] = -norm;
+        }
+        return full_rank;
+    }
+
+    // Gets the x minimizing |A * x - b|; which solves A * x = b for square matrices.
+    template<typename ScalarT, unsigned int Columns, unsigned int Rows>
+    inline impl::vec<ScalarT, Columns> qr_solve(const qr_factors<ScalarT, Columns, Rows>& factors, const impl::vec<ScalarT, Rows>& b)
+    {
+        const auto& qr = factors.qr;
+        auto y = b;
+
+        // y = transpose(Q) * b
+        for (auto k = 0u; k < Columns; k++)
+        {
+            ScalarT s(0);
+            for (auto i = k; i < Rows; i++)
+            {
+                s += qr(k, i) * y[i];
+            }
+            s = -s / qr(k, k);
+            for (auto i = k; i < Rows; i++)
+            {
+                y[i] += s * qr(k, i);
+            }
+        }
+
+        // R * x = y
+        impl::vec<ScalarT, Columns> x;
+        for (auto i = 0u; i < Columns; i++)
+        {
+            x[i] = y[i];
+        }
+        for (auto k = Columns; k-- > 0;)
+        {
+            x[k] /= factors.r_diagonal[k];
+            for (auto i = 0u; i < k; i++)
+            {
+                x[i] -= x[k] * qr(k, i);
+            }
+        }
+        return x;
+    }
+
+    // A = L * transpose(L); only the lower triangle of A is read. Returns false when A isn't positive-definite.
+    template<typename ScalarT, unsigned int Size>
+    inline bool cholesky_decompose(const impl::mat<ScalarT, Size, Size>& a, impl::mat<ScalarT, Size, Size>& lower)
+    {
+        ScalarT largest_diagonal(0);
+        for (auto j = 0u; j < Size; j++)
+        {
+            largest_diagonal = std::max(largest_diagonal, a(j, j));
+        }
+        const auto tolerance = impl::pivot_tolerance<ScalarT, Size>(largest_diagonal);
+        lower = impl::mat<ScalarT, Size, Size>(ScalarT(0));
+        for (auto j = 0u; j < Size; j++)
+        {
+            auto diagonal = a(j, j);
+            for (auto k = 0u; k < j; k++)
+            {
+                diagonal -= lower(k, j) * lower(k, j);
+            }
+            if (!(diagonal > tolerance))
+            {
+                return false;
+            }
+            lower(j, j) = std::sqrt(diagonal);
+
+            const auto inverse_diagonal = ScalarT(1) / lower(j, j);
+            for (auto i = j + 1; i < Size; i++)
+            {
+                lower(j, i) = a(j, i);
+            }
+            for (auto k = 0u; k < j; k++)
+            {
+                const auto l = lower(k, j);
+                for (auto i = j + 1; i < Size; i++)
+                {
+                    lower(j, i) -= lower(k, i) * l;
+                }
+            }
+            for (auto i = j + 1; i < Size; i++)
+            {
+                lower(j, i) *= inverse_diagonal;
+            }
+        }
+        return true;
+    }
+
+    template<typename ScalarT, unsigned int Size>
+    inline impl::vec<ScalarT, Size> cholesky_solve(const impl::mat<ScalarT, Size, Size>& lower, const impl::vec<ScalarT, Size>& b)
+    {
+        auto x = b;
+
+        // L * y = b
+        for (auto k = 0u; k < Size; k++)
+        {
+            x[k] /= lower(k, k);
+            for (auto i = k + 1; i < Size; i++)
+            {
+                x[i] -= lower(k, i) * x[k];
+            }
+        }
+
+        // transpose(L) * x = y
+        for (auto k = Size; k-- > 0;)
+        {
+            for (auto i = k + 1; i < Size; i++)
+            {
+                x[k] -= lower(k, i) * x[i];
+            }
+            x[k] /= lower(k, k);
+        }
+        return x;
+    }
+    // 3x3 Eigen-decomposition and SVD
+    ///////////////////////////////////
+
+    namespace impl
+    {
+        // Enough cyclic sweeps for any symmetric 3x3 to converge to double precision; 3x3 Jacobi converges quadratically.
+        constexpr unsigned int jacobi_sweeps = 5u;
+
+        // Symmetric 3x3 matrices, and their eigenvectors, as lanes; so each step of the solver is one straight loop over
+        // every lane, which the compiler can vectorize.
+        template<typename ScalarT, unsigned int Lanes>
+        struct symmetric3_lanes
+        {
+            ScalarT a00[Lanes], a11[Lanes], a22[Lanes], a01[Lanes], a02[Lanes], a12[Lanes];
+            ScalarT vectors[9][Lanes];  // column-major
+        };
+
+        // Rotates rows, and columns, p and q of every lane so apq becomes zero; r is the third row. vp and vq point at
+        // the eigenvector columns p and q. Branch free.
+        template<typename ScalarT, unsigned int Lanes>
+        inline void jacobi_rotate(
+            ScalarT (&app)[Lanes], ScalarT (&aqq)[Lanes], ScalarT (&apq)[Lanes], ScalarT (&arp)[Lanes], ScalarT (&arq)[Lanes],
+            ScalarT (* const vp)[Lanes], ScalarT (* const vq)[Lanes]
+            )
+        {
+            for (auto n = 0u; n < Lanes; n++)
+            {
+                // t = tan(angle), from the smaller root of t^2 + 2 * t * cot(2 * angle) - 1 = 0; zero when apq is zero.
+                const auto d = aqq[n] - app[n];
+                const auto t = std::copysign(ScalarT(2), d) * apq[n] /
+                    (std::abs(d) + std::sqrt(d * d + ScalarT(4) * apq[n] * apq[n]) + std::numeric_limits<ScalarT>::min());
+                const auto c = ScalarT(1) / std::sqrt(t * t + ScalarT(1));
+                const auto s = t * c;
+
+                app[n] -= t * apq[n];
+                aqq[n] += t * apq[n];
+                apq[n] = ScalarT(0);
+                const auto rp = arp[n];
+                arp[n] = c * rp - s * arq[n];
+                arq[n] = s * rp + c * arq[n];
+                for (auto i = 0u; i < 3; i++)
+                {
+                    const auto p = vp[i][n];
+                    vp[i][n] = c * p - s * vq[i][n];
+                    vq[i][n] = s * p + c * vq[i][n];
+                }
+            }
+        }
+
+        // Orders a pair of eigenvalues largest first; swapping the columns negates one, so the vectors stay a rotation.
+        template<typename ScalarT, unsigned int Lanes>
+        inline void order_eigen_pair(
+            ScalarT (&lp)[Lanes], ScalarT (&lq)[Lanes],
+            ScalarT (* const vp)[Lanes], ScalarT (* const vq)[Lanes]
+            )
+        {
+            for (auto n = 0u; n < Lanes; n++)
+            {
+                const auto swap = lp[n] < lq[n];
+                const auto l = lp[n];
+                lp[n] = swap ? lq[n] : l;
+                lq[n] = swap ? l : lq[n];
+                for (auto i = 0u; i < 3; i++)
+                {
+                    const auto p = vp[i][n];
+                    vp[i][n] = swap ? vq[i][n] : p;
+                    vq[i][n] = swap ? -p : vq[i][n];
+                }
+            }
+        }
+
+        // Eigen-decomposes every lane; the eigenvalues are largest first.
+        template<typename ScalarT, unsigned int Lanes>
+        inline void symmetric_eigen3(symmetric3_lanes<ScalarT, Lanes>& m, ScalarT (&values)[3][Lanes])
+        {
+            auto& v = m.vectors;
+            for (auto k = 0u; k < 9; k++)
+            {
+                for (auto n = 0u; n < Lanes; n++)
+                {
+                    v[k][n] = 0 == k % 4 ? ScalarT(1) : ScalarT(0);
+                }
+            }
+
+            for (auto sweep = 0u; sweep < jacobi_sweeps; sweep++)
+            {
+                jacobi_rotate(m.a00, m.a11, m.a01, m.a02, m.a12, &v[0], &v[3]);
+                jacobi_rotate(m.a00, m.a22, m.a02, m.a01, m.a12, &v[0], &v[6]);
+                jacobi_rotate(m.a11, m.a22, m.a12, m.a01, m.a02, &v[3], &v[6]);
+            }
+
+            for (auto n = 0u; n < Lanes; n++)
+            {
+                values[0][n] = m.a00[n];
+                values[1][n] = m.a11[n];
+                values[2][n] = m.a22[n];
+            }
+            order_eigen_pair(values[0], values[1], &v[0], &v[3]);
+            order_eigen_pair(values[1], values[2], &v[3], &v[6]);
+            order_eigen_pair(values[0], values[1], &v[0], &v[3]);
+        }
+
+        // Zeroes b(j, i) with a Givens rotation of rows j and i; and accumulates its transpose into the columns of u.
+        template<typename ScalarT>
+        inline void givens_qr_step(mat<ScalarT, 3, 3>& b, mat<ScalarT, 3, 3>& u, const unsigned int j, const unsigned int i)
+        {
+            const auto a1 = b(j, j);
+            const auto a2 = b(j, i);
+            const auto rho = std::sqrt(a1 * a1 + a2 * a2);
+            const auto usable = rho > std::numeric_limits<ScalarT>::min();
+            const auto c = usable ? a1 / rho : ScalarT(1);
+            const auto s = usable ? a2 / rho : ScalarT(0);
+            for (auto k = 0u; k < 3; k++)
+            {
+                const auto bj = b(k, j), bi = b(k, i);
+                b(k, j) = c * bj + s * bi;
+                b(k, i) = c * bi - s * bj;
+                const auto uj = u(j, k), ui = u(i, k);
+                u(j, k) = c * uj + s * ui;
+                u(i, k) = c * ui - s * uj;
+            }
+        }
+    } // namespace impl
+
+    // Gets the eigenvalues, largest first, and unit eigenvectors (the columns of a rotation) of a symmetric 3x3 matrix.
+    // Only the lower triangle is read.
+    template<typename ScalarT>
+    inline void symmetric_eigen(
+        const impl::mat<ScalarT, 3, 3>& a,
+        impl::vec<ScalarT, 3>& values,
+        impl::mat<ScalarT, 3, 3>& vectors
+        )
+    {
+        impl::symmetric3_lanes<ScalarT, 1> m = { { a(0, 0) }, { a(1, 1) }, { a(2, 2) }, { a(0, 1) }, { a(0, 2) }, { a(1, 2) }, {} };
+        ScalarT l[3][1];
+        impl::symmetric_eigen3(m, l);
+        values = impl::vec<ScalarT, 3>(l[0][0], l[1][0], l[2][0]);
+        vectors = impl::mat<ScalarT, 3, 3>(reinterpret_cast<const ScalarT(&)[9]>(m.vectors));
+    }
+
+    // Structure-of-arrays symmetric 3x3 matrices; the six unique elements of each in separate arrays.
+    template<typename ScalarT>
+    struct symmetric3_streams
+    {
+        const ScalarT* xx;
+        const ScalarT* yy;
+        const ScalarT* zz;
+        const ScalarT* xy;
+        const ScalarT* xz;
+        const ScalarT* yz;
+    };
+
+    // Eigen-decomposes matrices [first, last); values[k][n] is the k-th largest eigenvalue of matrix n, and
+    // vectors[column * 3 + row][n] an element of its eigenvector columns. Every matrix takes the same path, in blocks
+    // of lanes, so the solver vectorizes; GCC and Clang need -fno-math-errno to vectorize std::sqrt. Ranges can run on
+    // separate threads.
+    template<typename ScalarT>
+    inline void symmetric_eigen(
+        const symmetric3_streams<ScalarT>& matrices,
+        ScalarT* const (&values)[3],
+        ScalarT* const (&vectors)[9],
+        const size_t first,
+        const size_t last
+        )
+    {
+        assert(first <= last);
+        CLG_INSTRUMENT_SCOPE("symmetric_eigen", last - first);
+        constexpr auto lanes = 16u;
+        impl::symmetric3_lanes<ScalarT, lanes> m;
+        ScalarT l[3][lanes];
+        for (auto block = first; block < last; block += lanes)
+        {
+            // The lanes past the end of a partial block are zero matrices; which are harmless.
+            const auto count = static_cast<unsigned int>(std::min(size_t(lanes), last - block));
+            for (auto n = 0u; n < lanes; n++)
+            {
+                const auto i = block + (n < count ? n : 0u);
+                const auto used = n < count ? ScalarT(1) : ScalarT(0);
+                m.a00[n] = matrices.xx[i] * used;
+                m.a11[n] = matrices.yy[i] * used;
+                m.a22[n] = matrices.zz[i] * used;
+                m.a01[n] = matrices.xy[i] * used;
+                m.a02[n] = matrices.xz[i] * used;
+                m.a12[n] = matrices.yz[i] * used;
+            }
+
+            impl::symmetric_eigen3(m, l);
+
+            for (auto n = 0u; n < count; n++)
+            {
+                for (auto k = 0u; k < 3; k++)
+                {
+                    values[k][block + n] = l[k][n];
+                }
+                for (auto k = 0u; k < 9; k++)
+                {
+                    vectors[k][block + n] = m.vectors[k][n];
+                }
+            }
+        }
+    }
+
+    // A = u * diagonal(sigma) * transpose(v); where u and v are rotations, and sigma is largest first. So when A
+    // reflects, sigma.z is negative.
+    template<typename ScalarT>
+    inline void svd(
+        const impl::mat<ScalarT, 3, 3>& a,
+        impl::mat<ScalarT, 3, 3>& u,
+        impl::vec<ScalarT, 3>& sigma,
+        impl::mat<ScalarT, 3, 3>& v
+        )
+    {
+        // The eigenvectors of transpose(A) * A are the right singular vectors.
+        impl::vec<ScalarT, 3> squares;
+        symmetric_eigen(a.transpose() * a, squares, v);
+
+        // A * v = u * R, where R is diagonal up to rounding; Givens QR keeps rank deficient matrices well behaved.
+        auto b = a * v;
+        u = impl::mat<ScalarT, 3, 3>(ScalarT(1));
+        impl::givens_qr_step(b, u, 0u, 1u);
+        impl::givens_qr_step(b, u, 0u, 2u);
+        impl::givens_qr_step(b, u, 1u, 2u);
+        sigma = impl::vec<ScalarT, 3>(b(0, 0), b(1, 1), b(2, 2));
+    }
+
+    // A = rotation * stretch; where stretch is symmetric. When A reflects, the stretch carries the reflection.
+    template<typename ScalarT>
+    inline void polar_decompose(
+        const impl::mat<ScalarT, 3, 3>& a,
+        impl::mat<ScalarT, 3, 3>& rotation,
+        impl::mat<ScalarT, 3, 3>& stretch
+        )
+    {
+        impl::mat<ScalarT, 3, 3> u, v;
+        impl::vec<ScalarT, 3> sigma;
+        svd(a, u, sigma, v);
+        const auto v_transpose = v.transpose();
+        rotation = u * v_transpose;
+        impl::mat<ScalarT, 3, 3> scale(ScalarT(0));
+        scale(0, 0) = sigma.x;
+        scale(1, 1) = sigma.y;
+        scale(2, 2) = sigma.z;
+        stretch = v * scale * v_transpose;
+    }
+} // namespace clg
+
+#endif
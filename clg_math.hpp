@@ -7,6 +7,10 @@
 #ifndef CLGMATH_HPP
 #define CLGMATH_HPP
 
+#ifndef CLGINSTRUMENT_HPP
+  #include "clg_instrument.hpp"
+#endif
+
 namespace clg
 {
     template<typename T = float>
@@ -100,7 +104,7 @@ namespace clg
     inline constexpr T round_up_to_nearest_power_of_two(T number)
     {
         number--;
-        for (int i = 1; i < sizeof(T) * 8; i *= 2)
+        for (auto i = size_t(1); i < sizeof(T) * 8; i *= 2)
         {
             number |= number >> i;
         }
@@ -121,11 +125,92 @@ namespace clg
         return ++number;
     }
 
+    namespace impl
+    {
+        // De Bruijn sequence lookup for bit scans; works for a value with all the bits below its target bit set.
+        inline constexpr unsigned int de_bruijn_bit_index(const uint64_t smeared)
+        {
+            constexpr unsigned char index64[64] =
+            {
+                 0, 47,  1, 56, 48, 27,  2, 60, 57, 49, 41, 37, 28, 16,  3, 61,
+                54, 58, 35, 52, 50, 42, 21, 44, 38, 32, 29, 23, 17, 11,  4, 62,
+                46, 55, 26, 59, 40, 36, 15, 53, 34, 51, 20, 43, 31, 22, 10, 45,
+                25, 39, 14, 33, 19, 30,  9, 24, 13, 18,  8, 12,  7,  6,  5, 63
+            };
+            return index64[(smeared * 0x03f79d71b4cb0a89ull) >> 58];
+        }
+    } // namespace impl
+
+    // Gets the index of the least significant set bit. The result is undefined for 0.
+    inline constexpr unsigned int lowest_set_bit_index(const uint64_t value)
+    {
+        assert(0 != value);
+        return impl::de_bruijn_bit_index(value ^ (value - 1));
+    }
+
+    // Gets the index of the most significant set bit. The result is undefined for 0.
+    inline constexpr unsigned int highest_set_bit_index(uint64_t value)
+    {
+        assert(0 != value);
+        value |= value >> 1;
+        value |= value >> 2;
+        value |= value >> 4;
+        value |= value >> 8;
+        value |= value >> 16;
+        value |= value >> 32;
+        return impl::de_bruijn_bit_index(value);
+    }
+
+    // Gets the number of set bits.
+    inline constexpr unsigned int population_count(uint64_t value)
+    {
+        value = value - ((value >> 1) & 0x5555555555555555ull);
+        value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+        value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        return static_cast<unsigned int>((value * 0x0101010101010101ull) >> 56);
+    }
+
+    namespace impl
+    {
+        // the unsigned integer type of the given size in bytes
+        template<size_t Bytes>
+        using unsigned_bits = std::conditional_t<1 == Bytes, uint8_t, std::conditional_t<2 == Bytes, uint16_t,
+            std::conditional_t<4 == Bytes, uint32_t, std::conditional_t<8 == Bytes, uint64_t, void>>>>;
+
+        // the scalar type of a vector, matrix, or rect type; or the type itself for scalars
+        template<typename T, typename = void>
+        struct element_scalar
+        {
+            using type = T;
+        };
+
+        template<typename T>
+        struct element_scalar<T, std::void_t<typename T::scalar_type>>
+        {
+            using type = typename T::scalar_type;
+        };
+    } // namespace impl
+
+    // Reverses the byte order of an integer or floating-point value.
     template<typename T>
     inline constexpr T byte_swap(const T value)
     {
         static_assert(sizeof(T) >= 2 && sizeof(T) <= 8, "attempting to byte_swap an unsupported integer size");
-        if constexpr (2 == sizeof(T))
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            impl::unsigned_bits<sizeof(T)> bits;
+            std::memcpy(&bits, &value, sizeof(T));
+            bits = byte_swap(bits);
+            T result;
+            std::memcpy(&result, &bits, sizeof(T));
+            return result;
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            // Right shifts of negative values would smear the sign bit.
+            return static_cast<T>(byte_swap(static_cast<std::make_unsigned_t<T>>(value)));
+        }
+        else if constexpr (2 == sizeof(T))
         {
             return value >> 8 | value << 8;
         }
@@ -142,6 +227,164 @@ namespace clg
         }
     }
 
+    // Reverses the byte order of every scalar in count elements; the elements may be integer or floating-point scalars,
+    // or any vector, matrix, or rect type. It's a plain loop over the scalars; compilers turn it into vector byte
+    // shuffles where the target has them (pshufb with SSSE3, rev on NEON), or a bswap per scalar otherwise. input and
+    // output may be the same array, but mustn't otherwise overlap.
+    template<typename T>
+    inline void byte_swap_span(const T* const input, T* const output, const size_t count)
+    {
+        using scalar_type = typename impl::element_scalar<T>::type;
+        using bits_type = impl::unsigned_bits<sizeof(scalar_type)>;
+        static_assert(0 == sizeof(T) % sizeof(scalar_type), "elements must be arrays of their scalar type");
+        static_assert(!std::is_void_v<bits_type>, "attempting to byte_swap an unsupported scalar size");
+        assert((nullptr != input && nullptr != output) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("byte_swap_span", count);
+
+        const auto source = reinterpret_cast<const unsigned char*>(input);
+        const auto destination = reinterpret_cast<unsigned char*>(output);
+        const auto scalar_count = count * (sizeof(T) / sizeof(scalar_type));
+        if constexpr (1 == sizeof(scalar_type))
+        {
+            if (source != destination)
+            {
+                std::memcpy(destination, source, scalar_count);
+            }
+        }
+        else
+        {
+            for (auto i = size_t(0); i < scalar_count; i++)
+            {
+                bits_type bits;
+                std::memcpy(&bits, source + i * sizeof(bits_type), sizeof(bits_type));
+                bits = byte_swap(bits);
+                std::memcpy(destination + i * sizeof(bits_type), &bits, sizeof(bits_type));
+            }
+        }
+    }
+
+    // Reverses the byte order of every scalar in count elements, in place.
+    template<typename T>
+    inline void byte_swap_span(T* const values, const size_t count)
+    {
+        byte_swap_span(static_cast<const T*>(values), values, count);
+    }
+
+    // Adds two integers, clamping to the type's limits instead of wrapping around.
+    template<typename T>
+    inline constexpr T saturating_add(const T lhs, const T rhs)
+    {
+        static_assert(std::is_integral_v<T>, "saturating_add() is for integer types");
+        using unsigned_type = std::make_unsigned_t<T>;
+        const auto sum = static_cast<unsigned_type>(static_cast<unsigned_type>(lhs) + static_cast<unsigned_type>(rhs));
+        if constexpr (std::is_unsigned_v<T>)
+        {
+            return sum < lhs ? std::numeric_limits<T>::max() : sum;
+        }
+        else
+        {
+            // Overflowed if both operands have the same sign, and the sum doesn't; the limit takes lhs's sign.
+            const auto limit = static_cast<T>((static_cast<unsigned_type>(lhs) >> (sizeof(T) * 8 - 1)) + static_cast<unsigned_type>(std::numeric_limits<T>::max()));
+            const auto overflowed = static_cast<T>(~(static_cast<unsigned_type>(lhs) ^ static_cast<unsigned_type>(rhs)) & (static_cast<unsigned_type>(lhs) ^ sum)) < 0;
+            return overflowed ? limit : static_cast<T>(sum);
+        }
+    }
+
+    // Subtracts two integers, clamping to the type's limits instead of wrapping around.
+    template<typename T>
+    inline constexpr T saturating_sub(const T lhs, const T rhs)
+    {
+        static_assert(std::is_integral_v<T>, "saturating_sub() is for integer types");
+        using unsigned_type = std::make_unsigned_t<T>;
+        const auto difference = static_cast<unsigned_type>(static_cast<unsigned_type>(lhs) - static_cast<unsigned_type>(rhs));
+        if constexpr (std::is_unsigned_v<T>)
+        {
+            return rhs > lhs ? T(0) : difference;
+        }
+        else
+        {
+            // Overflowed if the operands have different signs, and the difference doesn't have lhs's sign.
+            const auto limit = static_cast<T>((static_cast<unsigned_type>(lhs) >> (sizeof(T) * 8 - 1)) + static_cast<unsigned_type>(std::numeric_limits<T>::max()));
+            const auto overflowed = static_cast<T>((static_cast<unsigned_type>(lhs) ^ static_cast<unsigned_type>(rhs)) & (static_cast<unsigned_type>(lhs) ^ difference)) < 0;
+            return overflowed ? limit : static_cast<T>(difference);
+        }
+    }
+
+    // Adds two integers; returns false, instead of wrapping around, if the sum doesn't fit.
+    template<typename T>
+    inline constexpr bool checked_add(const T lhs, const T rhs, T& sum)
+    {
+        static_assert(std::is_integral_v<T>, "checked_add() is for integer types");
+        if constexpr (std::is_unsigned_v<T>)
+        {
+            sum = static_cast<T>(lhs + rhs);
+            return sum >= lhs;
+        }
+        else
+        {
+            using unsigned_type = std::make_unsigned_t<T>;
+            sum = static_cast<T>(static_cast<unsigned_type>(lhs) + static_cast<unsigned_type>(rhs));
+            return static_cast<T>(~(static_cast<unsigned_type>(lhs) ^ static_cast<unsigned_type>(rhs)) & (static_cast<unsigned_type>(lhs) ^ static_cast<unsigned_type>(sum))) >= 0;
+        }
+    }
+
+    // Subtracts two integers; returns false, instead of wrapping around, if the difference doesn't fit.
+    template<typename T>
+    inline constexpr bool checked_sub(const T lhs, const T rhs, T& difference)
+    {
+        static_assert(std::is_integral_v<T>, "checked_sub() is for integer types");
+        if constexpr (std::is_unsigned_v<T>)
+        {
+            difference = static_cast<T>(lhs - rhs);
+            return rhs <= lhs;
+        }
+        else
+        {
+            using unsigned_type = std::make_unsigned_t<T>;
+            difference = static_cast<T>(static_cast<unsigned_type>(lhs) - static_cast<unsigned_type>(rhs));
+            return static_cast<T>((static_cast<unsigned_type>(lhs) ^ static_cast<unsigned_type>(rhs)) & (static_cast<unsigned_type>(lhs) ^ static_cast<unsigned_type>(difference))) >= 0;
+        }
+    }
+
+    // Converts between arithmetic types; returns false if the value doesn't survive the trip. That includes fractions
+    // and NaN going to an integer type. Out of range values are rejected before anything is converted that would be
+    // undefined; result is left alone then.
+    template<typename DstT, typename SrcT>
+    inline constexpr bool checked_cast(const SrcT value, DstT& result)
+    {
+        if constexpr (std::is_floating_point_v<SrcT> && std::is_integral_v<DstT>)
+        {
+            // 2^bits (or 2^(bits - 1) when signed) is exact in any floating-point type; NaN fails both tests.
+            const auto limit = static_cast<SrcT>(std::numeric_limits<DstT>::max() / 2 + 1) * SrcT(2);
+            if (!(value < limit && (std::is_signed_v<DstT> ? value >= -limit : value > SrcT(-1))))
+            {
+                return false;
+            }
+        }
+        else if constexpr (std::is_floating_point_v<SrcT> && std::is_floating_point_v<DstT> && sizeof(DstT) < sizeof(SrcT))
+        {
+            constexpr auto infinity = std::numeric_limits<SrcT>::infinity();
+            const auto limit = static_cast<SrcT>(std::numeric_limits<DstT>::max());
+            if ((value > limit && value != infinity) || (value < -limit && value != -infinity))
+            {
+                return false;
+            }
+        }
+
+        const auto converted = static_cast<DstT>(value);
+        if constexpr (std::is_integral_v<SrcT> && std::is_floating_point_v<DstT>)
+        {
+            // A big integer can round up to 2^bits (2^(bits - 1) when signed); converting that back would be undefined.
+            if (converted >= static_cast<DstT>(std::numeric_limits<SrcT>::max() / 2 + 1) * DstT(2))
+            {
+                return false;
+            }
+        }
+
+        result = converted;
+        return static_cast<SrcT>(result) == value && (value < SrcT(0)) == (result < DstT(0));
+    }
+
     // Nudges an integer count up until it is a multiple of the specified power of two in the template parameter.
     template<unsigned int PowerOfTwo>
     inline constexpr unsigned int round_up_to_alignment(const unsigned int odd_value)
@@ -380,6 +623,84 @@ namespace clg
         return interpolate_inout(interpolate_in_func(), interpolate_out_func(), start, end, x);
     }
 
+    /// <summary>
+    /// Linearly blends a into b by t; a + (b - a) * t. Works on floating-point scalars, and any vector, matrix, or rect
+    /// type of them, a scalar at a time.
+    /// </summary>
+    template<typename T>
+    inline T mix(const T& a, const T& b, const typename impl::element_scalar<T>::type t)
+    {
+        using scalar_type = typename impl::element_scalar<T>::type;
+        static_assert(std::is_floating_point_v<scalar_type>, "mix() blends floating-point types");
+        constexpr auto scalar_count = sizeof(T) / sizeof(scalar_type);
+
+        T result(a);
+        const auto lhs = reinterpret_cast<const scalar_type*>(&a);
+        const auto rhs = reinterpret_cast<const scalar_type*>(&b);
+        const auto blend = reinterpret_cast<scalar_type*>(&result);
+        for (auto i = 0u; i < scalar_count; i++)
+        {
+            blend[i] = lhs[i] + (rhs[i] - lhs[i]) * t;
+        }
+        return result;
+    }
+
+    /// <summary>
+    /// Blends count pairs of elements by one shared weight; from interpolate() for a shaped curve. The blend runs over
+    /// the whole span as one flat array of scalars. results may be a or b.
+    /// </summary>
+    template<typename T>
+    inline void mix(const T* const a, const T* const b, const typename impl::element_scalar<T>::type t, T* const results, const size_t count)
+    {
+        using scalar_type = typename impl::element_scalar<T>::type;
+        static_assert(std::is_floating_point_v<scalar_type>, "mix() blends floating-point types");
+        assert((nullptr != a && nullptr != b && nullptr != results) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("mix", count);
+
+        const auto lhs = reinterpret_cast<const scalar_type*>(a);
+        const auto rhs = reinterpret_cast<const scalar_type*>(b);
+        const auto blend = reinterpret_cast<scalar_type*>(results);
+        const auto scalar_count = count * (sizeof(T) / sizeof(scalar_type));
+        for (auto i = size_t(0); i < scalar_count; i++)
+        {
+            blend[i] = lhs[i] + (rhs[i] - lhs[i]) * t;
+        }
+    }
+
+    /// <summary>
+    /// Blends count pairs of elements, each by its own weight shaped by an interp:: function; interp(t[i]). results may
+    /// be a or b.
+    /// </summary>
+    template<typename T, typename interpolate_func = interp::linear>
+    inline void mix(
+        const T* const a,
+        const T* const b,
+        const float* const t,
+        T* const results,
+        const size_t count,
+        const interpolate_func interp = interpolate_func()
+        )
+    {
+        using scalar_type = typename impl::element_scalar<T>::type;
+        static_assert(std::is_floating_point_v<scalar_type>, "mix() blends floating-point types");
+        constexpr auto scalar_count = sizeof(T) / sizeof(scalar_type);
+        assert((nullptr != a && nullptr != b && nullptr != t && nullptr != results) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("mix", count);
+
+        const auto lhs = reinterpret_cast<const scalar_type*>(a);
+        const auto rhs = reinterpret_cast<const scalar_type*>(b);
+        const auto blend = reinterpret_cast<scalar_type*>(results);
+        for (auto i = size_t(0); i < count; i++)
+        {
+            const auto weight = static_cast<scalar_type>(interp(t[i]));
+            for (auto j = size_t(0); j < scalar_count; j++)
+            {
+                const auto k = i * scalar_count + j;
+                blend[k] = lhs[k] + (rhs[k] - lhs[k]) * weight;
+            }
+        }
+    }
+
     namespace vec_util
     {
         // assign the elements of the source vector to the elements of the destination vector
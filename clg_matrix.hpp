@@ -87,7 +87,7 @@ namespace clg { namespace impl
 
         constexpr mat()
         {
-            clg::mat_util::assign_diagonal<column_count, row_count>(_scalars, 1.0f);
+            clg::mat_util::assign_diagonal<column_count, row_count>(_scalars, static_cast<scalar_type>(1));
         }
 
         constexpr mat(const mat& original)
@@ -466,6 +466,7 @@ namespace clg { namespace impl
         template<unsigned int rhsColumns>
         constexpr mat<scalar_type, rhsColumns, row_count> operator *(const mat<scalar_type, rhsColumns, column_count>& rhs) const
         {
+            CLG_INSTRUMENT_COUNT(matrix_multiply);
             scalar_type result[row_count * rhsColumns];
             clg::mat_util::multiply<row_count, column_count, rhsColumns>(result, _scalars, rhs.data());
             return mat<scalar_type, rhsColumns, row_count>(result);
@@ -480,6 +481,7 @@ namespace clg { namespace impl
 
         constexpr mat& operator *=(const mat& rhs)
         {
+            CLG_INSTRUMENT_COUNT(matrix_multiply);
             array_type result;
             clg::mat_util::multiply<row_count, column_count, column_count>(result, _scalars, rhs._scalars);
             clg::vec_util::assign(_scalars, result);
@@ -648,7 +650,7 @@ namespace clg { namespace impl
         mat3 result;
         for (auto i = 0u; i < std::remove_reference_t<decltype(translation)>::dimension_count; i++)
         {
-            result(1, i) = translation[i];
+            result(2, i) = translation[i];
         }
         return result;
     }
@@ -1020,6 +1022,401 @@ namespace clg { namespace impl
         return result;
     }
 
+    // Infinite and Reversed-Z Projection Matrices
+    //////////////////////////////////////////////
+
+    // Like perspective_projection_matrix_gl(), but with the far plane at infinity; z / w approaches 1 far away.
+    inline constexpr mat4 infinite_perspective_projection_matrix_gl(
+        const float left,
+        const float right,
+        const float bottom,
+        const float top,
+        const float near
+        )
+    {
+        mat4 result;
+        result(0, 0) = (2.0f * near) / (right - left);
+        result(2, 0) = (right + left) / (right - left);
+        result(1, 1) = (2.0f * near) / (top - bottom);
+        result(2, 1) = (top + bottom) / (top - bottom);
+        result(2, 2) = -1.0f;
+        result(3, 2) = -2.0f * near;
+        result(2, 3) = -1.0f;
+        result(3, 3) = 0.0f;
+        return result;
+    }
+
+    // Like perspective_projection_matrix_dx(), but with the far plane at infinity; z / w approaches 1 far away.
+    inline constexpr mat4 infinite_perspective_projection_matrix_dx(
+        const float left,
+        const float right,
+        const float bottom,
+        const float top,
+        const float near
+        )
+    {
+        mat4 result;
+        result(0, 0) = (2.0f * near) / (right - left);
+        result(2, 0) = (right + left) / (right - left);
+        result(1, 1) = (2.0f * near) / (top - bottom);
+        result(2, 1) = (top + bottom) / (top - bottom);
+        result(2, 2) = 1.0f;
+        result(3, 2) = -near;
+        result(2, 3) = 1.0f;
+        result(3, 3) = 0.0f;
+        return result;
+    }
+
+    // Like perspective_projection_matrix_gl(), looking down -z, but with reversed depth; z / w is 1 at the near plane,
+    // and 0 at the far plane. Reversed-Z only gains precision with a [0, 1] clip depth range, so use it with
+    // glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE), a GL_GREATER depth test, and a depth clear of 0. far may be infinity.
+    inline constexpr mat4 reversed_z_perspective_projection_matrix_gl(
+        const float left,
+        const float right,
+        const float bottom,
+        const float top,
+        const float near,
+        const float far
+        )
+    {
+        // NOTE: near / (1 - near / far) is near * far / (far - near), without dividing infinity by infinity.
+        mat4 result;
+        result(0, 0) = (2.0f * near) / (right - left);
+        result(2, 0) = (right + left) / (right - left);
+        result(1, 1) = (2.0f * near) / (top - bottom);
+        result(2, 1) = (top + bottom) / (top - bottom);
+        result(2, 2) = near / (far - near);
+        result(3, 2) = near / (1.0f - near / far);
+        result(2, 3) = -1.0f;
+        result(3, 3) = 0.0f;
+        return result;
+    }
+
+    // Like perspective_projection_matrix_dx(), looking down +z, but with reversed depth; z / w is 1 at the near plane,
+    // and 0 at the far plane. Use it with a greater depth test, and a depth clear of 0. far may be infinity.
+    inline constexpr mat4 reversed_z_perspective_projection_matrix_dx(
+        const float left,
+        const float right,
+        const float bottom,
+        const float top,
+        const float near,
+        const float far
+        )
+    {
+        mat4 result;
+        result(0, 0) = (2.0f * near) / (right - left);
+        result(2, 0) = (right + left) / (right - left);
+        result(1, 1) = (2.0f * near) / (top - bottom);
+        result(2, 1) = (top + bottom) / (top - bottom);
+        result(2, 2) = -(near / (far - near));
+        result(3, 2) = near / (1.0f - near / far);
+        result(2, 3) = 1.0f;
+        result(3, 3) = 0.0f;
+        return result;
+    }
+
+    // Landscape perspective projections, with the far plane at infinity; or with reversed depth.
+    inline mat4 infinite_perspective_projection_matrix_gl(
+        const float verticalFieldOfView,          // in radians
+        const float aspectRatioWidthOverHeight,   // width / height
+        const float near                          // always positive
+        )
+    {
+        assert(verticalFieldOfView > 0.0f && verticalFieldOfView < trig<>::pi);
+        assert(near > 0.0f);
+
+        const auto halfHeight = std::tan(verticalFieldOfView * 0.5f) * near;
+        const auto halfWidth = halfHeight * aspectRatioWidthOverHeight;
+        return infinite_perspective_projection_matrix_gl(-halfWidth, halfWidth, -halfHeight, halfHeight, near);
+    }
+
+    inline mat4 infinite_perspective_projection_matrix_dx(
+        const float verticalFieldOfView,          // in radians
+        const float aspectRatioWidthOverHeight,   // width / height
+        const float near                          // always positive
+        )
+    {
+        assert(verticalFieldOfView > 0.0f && verticalFieldOfView < trig<>::pi);
+        assert(near > 0.0f);
+
+        const auto halfHeight = std::tan(verticalFieldOfView * 0.5f) * near;
+        const auto halfWidth = halfHeight * aspectRatioWidthOverHeight;
+        return infinite_perspective_projection_matrix_dx(-halfWidth, halfWidth, -halfHeight, halfHeight, near);
+    }
+
+    inline mat4 reversed_z_perspective_projection_matrix_gl(
+        const float verticalFieldOfView,          // in radians
+        const float aspectRatioWidthOverHeight,   // width / height
+        const float near,                         // always positive
+        const float far                           // always positive; may be infinity
+        )
+    {
+        assert(verticalFieldOfView > 0.0f && verticalFieldOfView < trig<>::pi);
+        assert(near > 0.0f);
+        assert(far > near);
+
+        const auto halfHeight = std::tan(verticalFieldOfView * 0.5f) * near;
+        const auto halfWidth = halfHeight * aspectRatioWidthOverHeight;
+        return reversed_z_perspective_projection_matrix_gl(-halfWidth, halfWidth, -halfHeight, halfHeight, near, far);
+    }
+
+    inline mat4 reversed_z_perspective_projection_matrix_dx(
+        const float verticalFieldOfView,          // in radians
+        const float aspectRatioWidthOverHeight,   // width / height
+        const float near,                         // always positive
+        const float far                           // always positive; may be infinity
+        )
+    {
+        assert(verticalFieldOfView > 0.0f && verticalFieldOfView < trig<>::pi);
+        assert(near > 0.0f);
+        assert(far > near);
+
+        const auto halfHeight = std::tan(verticalFieldOfView * 0.5f) * near;
+        const auto halfWidth = halfHeight * aspectRatioWidthOverHeight;
+        return reversed_z_perspective_projection_matrix_dx(-halfWidth, halfWidth, -halfHeight, halfHeight, near, far);
+    }
+
+    // Depth Linearization
+    //////////////////////
+
+    // the clip space depth range a projection matrix was made for
+    enum class clip_depth_range
+    {
+        negative_one_to_one,    // OpenGL's default; window depth = (z / w + 1) / 2
+        zero_to_one             // DirectX, Vulkan, or glClipControl(..., GL_ZERO_TO_ONE); window depth = z / w
+    };
+
+    // Converts between depth buffer values and linear view depths (the distance in front of the camera, along its
+    // view direction) for any projection matrix; perspective or orthographic, standard, reversed, or infinite. Both
+    // directions are a ratio of linear functions, (p + q * x) / (r + s * x), with constants derived from the matrix.
+    class depth_linearizer
+    {
+    public:
+        depth_linearizer(const mat4& projection, const clip_depth_range range)
+        {
+            // Only the third and fourth rows matter: z_clip = m22 * z + m32, and w_clip = m23 * z + m33. A depth
+            // buffer value d is the clip depth a * d + b.
+            const auto m22 = projection(2, 2), m32 = projection(3, 2), m23 = projection(2, 3), m33 = projection(3, 3);
+            const auto a = clip_depth_range::negative_one_to_one == range ? 2.0f : 1.0f;
+            const auto b = clip_depth_range::negative_one_to_one == range ? -1.0f : 0.0f;
+
+            // The view direction; perspective w grows along it, and (standard) orthographic clip depth grows along it.
+            const auto forward = 0.0f != m23 ? (m23 < 0.0f ? -1.0f : 1.0f) : (m22 < 0.0f ? -1.0f : 1.0f);
+
+            // depth: solving (a * d + b) * (m23 * z + m33) = m22 * z + m32 for z, then scaling z by forward
+            _to_linear[0] = forward * (m32 - b * m33);
+            _to_linear[1] = forward * -a * m33;
+            _to_linear[2] = b * m23 - m22;
+            _to_linear[3] = a * m23;
+
+            // the inverse; d = ((m22 * z + m32) / (m23 * z + m33) - b) / a, with z = forward * depth
+            _to_depth[0] = m32 - b * m33;
+            _to_depth[1] = forward * (m22 - b * m23);
+            _to_depth[2] = a * m33;
+            _to_depth[3] = forward * a * m23;
+        }
+
+        // Gets the view depth of a depth buffer value.
+        float linearize(const float depth) const
+        {
+            return (_to_linear[0] + _to_linear[1] * depth) / (_to_linear[2] + _to_linear[3] * depth);
+        }
+
+        // Gets the depth buffer value of a view depth.
+        float delinearize(const float view_depth) const
+        {
+            return (_to_depth[0] + _to_depth[1] * view_depth) / (_to_depth[2] + _to_depth[3] * view_depth);
+        }
+
+        // Converts count depth buffer values to view depths; input and output may be the same array.
+        void linearize(const float* const depths, float* const view_depths, const size_t count) const
+        {
+            assert((nullptr != depths && nullptr != view_depths) || 0 == count);
+            CLG_INSTRUMENT_SCOPE("linearize_depth", count);
+            ratio(_to_linear, depths, view_depths, count);
+        }
+
+        // Converts count view depths to depth buffer values; input and output may be the same array.
+        void delinearize(const float* const view_depths, float* const depths, const size_t count) const
+        {
+            assert((nullptr != view_depths && nullptr != depths) || 0 == count);
+            CLG_INSTRUMENT_SCOPE("delinearize_depth", count);
+            ratio(_to_depth, view_depths, depths, count);
+        }
+
+    private:
+        static void ratio(const float (&constants)[4], const float* const input, float* const output, const size_t count)
+        {
+            // Copies of the constants, so the compiler knows the stores can't change them, and vectorizes the loop.
+            const auto p = constants[0], q = constants[1], r = constants[2], s = constants[3];
+            for (auto i = size_t(0); i < count; i++)
+            {
+                output[i] = (p + q * input[i]) / (r + s * input[i]);
+            }
+        }
+
+        float _to_linear[4];
+        float _to_depth[4];
+    };
+
+    // Decomposition
+    ////////////////
+
+    // An affine transform split into translation_matrix(translation) * rotation * shear * scaling_matrix(scale); where the
+    // shear is shearing_matrix_yz(shear.z) * shearing_matrix_xz(shear.y) * shearing_matrix_xy(shear.x).
+    struct transform_parts
+    {
+        vec3 translation;
+        mat3 rotation;  // orthonormal, without reflection
+        vec3 scale;     // all negative when the transform reflects
+        vec3 shear;     // xy, xz, yz
+    };
+
+    // Splits an affine transform into its parts; the bottom row is ignored.
+    // Returns false when an axis collapses to zero scale; the rotation is still orthonormal, but the shear of that axis is lost.
+    inline bool decompose(const mat4& matrix, transform_parts& parts)
+    {
+        const vec3 x_axis(matrix(0, 0), matrix(0, 1), matrix(0, 2));
+        const vec3 y_axis(matrix(1, 0), matrix(1, 1), matrix(1, 2));
+        const vec3 z_axis(matrix(2, 0), matrix(2, 1), matrix(2, 2));
+        const auto longest = std::max(x_axis.length(), std::max(y_axis.length(), z_axis.length()));
+        const auto tolerance = std::numeric_limits<float>::epsilon() * longest;
+
+        // Gram-Schmidt the columns into the rotation; what's left over is the scale and shear.
+        auto scale_x = x_axis.length();
+        auto x = x_axis / scale_x;
+        auto exact = scale_x > tolerance;
+        if (!exact)
+        {
+            // Prefer an axis that keeps the other columns intact.
+            const auto normal = y_axis.cross(z_axis);
+            x = normal.length() > tolerance * longest ? normal.unit() : vec3(1.0f, 0.0f, 0.0f);
+            scale_x = 0.0f;
+        }
+
+        const auto xy = x.dot(y_axis);
+        const auto y_remainder = y_axis - x * xy;
+        auto scale_y = y_remainder.length();
+        auto y = y_remainder / scale_y;
+        if (!(scale_y > tolerance))
+        {
+            const auto normal = z_axis.cross(x);
+            y = normal.length() > tolerance ? normal.unit() :
+                (std::abs(x.x) < 0.9f ? x.cross(vec3(1.0f, 0.0f, 0.0f)) : x.cross(vec3(0.0f, 1.0f, 0.0f))).unit();
+            scale_y = 0.0f;
+            exact = false;
+        }
+
+        const auto xz = x.dot(z_axis);
+        const auto yz = y.dot(z_axis);
+        const auto z_remainder = z_axis - x * xz - y * yz;
+        auto scale_z = z_remainder.length();
+        auto z = z_remainder / scale_z;
+        if (!(scale_z > tolerance))
+        {
+            z = x.cross(y);
+            scale_z = 0.0f;
+            exact = false;
+        }
+
+        parts.shear = vec3(
+            scale_y > 0.0f ? xy / scale_y : 0.0f,
+            scale_z > 0.0f ? xz / scale_z : 0.0f,
+            scale_z > 0.0f ? yz / scale_z : 0.0f);
+
+        // A reflection is folded into the scale, so the rotation stays a rotation; the shear is unchanged by it.
+        if (x.dot(y.cross(z)) < 0.0f)
+        {
+            x = -x; y = -y; z = -z;
+            scale_x = -scale_x; scale_y = -scale_y; scale_z = -scale_z;
+        }
+
+        parts.translation = vec3(matrix(3, 0), matrix(3, 1), matrix(3, 2));
+        parts.scale = vec3(scale_x, scale_y, scale_z);
+        for (auto i = 0u; i < 3; i++)
+        {
+            parts.rotation(0, i) = x[i];
+            parts.rotation(1, i) = y[i];
+            parts.rotation(2, i) = z[i];
+        }
+        return exact;
+    }
+
+    inline transform_parts decompose(const mat4& matrix)
+    {
+        transform_parts parts;
+        decompose(matrix, parts);
+        return parts;
+    }
+
+    // Decomposes count matrices; returns the number that decomposed exactly.
+    inline size_t decompose(const mat4* const matrices, const size_t count, transform_parts* const results)
+    {
+        assert((nullptr != matrices && nullptr != results) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("decompose", count);
+        auto exact = size_t(0);
+        for (auto i = size_t(0); i < count; i++)
+        {
+            exact += decompose(matrices[i], results[i]) ? 1 : 0;
+        }
+        return exact;
+    }
+
+    // Rebuilds translation_matrix(translation) * rotation * shear * scaling_matrix(scale); without the matrix products.
+    inline mat4 compose(const transform_parts& parts)
+    {
+        const auto& r = parts.rotation;
+        const auto& h = parts.shear;
+        const auto& s = parts.scale;
+        mat4 result;
+        for (auto i = 0u; i < 3; i++)
+        {
+            result(0, i) = r(0, i) * s.x;
+            result(1, i) = (r(0, i) * h.x + r(1, i)) * s.y;
+            result(2, i) = (r(0, i) * h.y + r(1, i) * h.z + r(2, i)) * s.z;
+            result(3, i) = parts.translation[i];
+        }
+        return result;
+    }
+
+    inline void compose(const transform_parts* const parts, const size_t count, mat4* const results)
+    {
+        assert((nullptr != parts && nullptr != results) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("compose", count);
+        for (auto i = size_t(0); i < count; i++)
+        {
+            results[i] = compose(parts[i]);
+        }
+    }
+
+    // Normal Matrix
+    ////////////////
+
+    // Gets the inverse-transpose of the upper 3x3 of a model matrix, for transforming normals.
+    // It is built from the cofactors, so a singular matrix still yields the unscaled cofactor matrix.
+    inline mat3 normal_matrix(const mat4& model)
+    {
+        const vec3 x_axis(model(0, 0), model(0, 1), model(0, 2));
+        const vec3 y_axis(model(1, 0), model(1, 1), model(1, 2));
+        const vec3 z_axis(model(2, 0), model(2, 1), model(2, 2));
+        const auto yz = y_axis.cross(z_axis);
+        const auto zx = z_axis.cross(x_axis);
+        const auto xy = x_axis.cross(y_axis);
+        const auto determinant = x_axis.dot(yz);
+        const auto inverse_determinant = 0.0f != determinant ? 1.0f / determinant : 1.0f;
+        return mat3(yz * inverse_determinant, zx * inverse_determinant, xy * inverse_determinant);
+    }
+
+    inline void normal_matrices(const mat4* const models, const size_t count, mat3* const results)
+    {
+        assert((nullptr != models && nullptr != results) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("normal_matrices", count);
+        for (auto i = size_t(0); i < count; i++)
+        {
+            results[i] = normal_matrix(models[i]);
+        }
+    }
+
     // Casts a vector to a single column matrix.
     template<typename scalar_type, unsigned int row_count>
     inline constexpr const impl::mat<scalar_type, 1u, row_count>& cast_column_matrix(const impl::base_vec<scalar_type, row_count>& column_vector)
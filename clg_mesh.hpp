@@ -0,0 +1,230 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGMESH_HPP
+#define CLGMESH_HPP
+
+#ifndef CLGVECTOR_HPP
+  #include "clg_vector.hpp"
+#endif
+
+/*
+ *
+ * Normals and tangent frames for indexed triangle meshes; three indices per triangle, counter-clockwise.
+ *
+ * Each step is either a per-triangle kernel over a triangle range, or a per-vertex kernel over a vertex range. A
+ * triangle kernel only writes its own triangles' slots, and a vertex kernel gathers from the triangles around each
+ * vertex (through vertex_triangles) instead of scattering into the vertices; so ranges can run on different threads
+ * without atomics or locks, and the results don't depend on how the mesh was split.
+ *
+ * Example:
+ *  clg::vertex_triangles adjacency;
+ *  adjacency.build(indices, triangle_count, vertex_count);                 // once per topology
+ *  clg::face_area_normals(positions, indices, faces, first_triangle, last_triangle);  // per thread, then sync
+ *  clg::vertex_normals(adjacency, faces, normals, first_vertex, last_vertex);        // per thread
+ *
+ */
+
+namespace clg
+{
+    // The triangles around each vertex; built once for a mesh's topology.
+    class vertex_triangles
+    {
+    public:
+        template<typename IndexT>
+        void build(const IndexT* const indices, const size_t triangle_count, const size_t vertex_count)
+        {
+            assert(nullptr != indices || 0 == triangle_count);
+
+            // Counting sort of the corners by vertex.
+            _offsets.assign(vertex_count + 1, 0u);
+            for (auto i = size_t(0); i < triangle_count * 3; i++)
+            {
+                assert(static_cast<size_t>(indices[i]) < vertex_count);
+                _offsets[static_cast<size_t>(indices[i]) + 1]++;
+            }
+            for (auto v = size_t(0); v < vertex_count; v++)
+            {
+                _offsets[v + 1] += _offsets[v];
+            }
+
+            _triangles.resize(triangle_count * 3);
+            for (auto i = size_t(0); i < triangle_count * 3; i++)
+            {
+                _triangles[_offsets[static_cast<size_t>(indices[i])]++] = static_cast<uint32_t>(i / 3);
+            }
+
+            // Each offset now points at the next vertex's start; shift them back.
+            for (auto v = vertex_count; v > 0; v--)
+            {
+                _offsets[v] = _offsets[v - 1];
+            }
+            _offsets[0] = 0u;
+        }
+
+        size_t vertex_count() const
+        {
+            return _offsets.empty() ? 0 : _offsets.size() - 1;
+        }
+
+        const uint32_t* begin(const size_t vertex) const
+        {
+            assert(vertex < vertex_count());
+            return _triangles.data() + _offsets[vertex];
+        }
+
+        const uint32_t* end(const size_t vertex) const
+        {
+            assert(vertex < vertex_count());
+            return _triangles.data() + _offsets[vertex + 1];
+        }
+
+    private:
+        std::vector<uint32_t> _offsets;
+        std::vector<uint32_t> _triangles;
+    };
+
+    // Gets the unit normal of triangles [first, last).
+    template<typename IndexT>
+    inline void face_normals(
+        const vec3* const positions,
+        const IndexT* const indices,
+        vec3* const normals,
+        const size_t first,
+        const size_t last
+        )
+    {
+        assert(nullptr != positions && nullptr != indices && nullptr != normals && first <= last);
+        CLG_INSTRUMENT_SCOPE("face_normals", last - first);
+        for (auto t = first; t < last; t++)
+        {
+            const auto& v0 = positions[indices[t * 3 + 0]];
+            const auto& v1 = positions[indices[t * 3 + 1]];
+            const auto& v2 = positions[indices[t * 3 + 2]];
+            normals[t] = (v1 - v0).cross(v2 - v0).unit();
+        }
+    }
+
+    // Gets the normal of triangles [first, last), with a length of twice the triangle's area; for vertex_normals().
+    template<typename IndexT>
+    inline void face_area_normals(
+        const vec3* const positions,
+        const IndexT* const indices,
+        vec3* const normals,
+        const size_t first,
+        const size_t last
+        )
+    {
+        assert(nullptr != positions && nullptr != indices && nullptr != normals && first <= last);
+        CLG_INSTRUMENT_SCOPE("face_area_normals", last - first);
+        for (auto t = first; t < last; t++)
+        {
+            const auto& v0 = positions[indices[t * 3 + 0]];
+            const auto& v1 = positions[indices[t * 3 + 1]];
+            const auto& v2 = positions[indices[t * 3 + 2]];
+            normals[t] = (v1 - v0).cross(v2 - v0);
+        }
+    }
+
+    // Gets the area weighted, smooth, unit normal of vertices [first, last) from the face_area_normals() of the whole mesh.
+    inline void vertex_normals(
+        const vertex_triangles& adjacency,
+        const vec3* const face_area_normals,
+        vec3* const normals,
+        const size_t first,
+        const size_t last
+        )
+    {
+        assert(nullptr != face_area_normals && nullptr != normals && first <= last && last <= adjacency.vertex_count());
+        CLG_INSTRUMENT_SCOPE("vertex_normals", last - first);
+        for (auto v = first; v < last; v++)
+        {
+            vec3 sum(0.0f, 0.0f, 0.0f);
+            for (auto t = adjacency.begin(v); t != adjacency.end(v); t++)
+            {
+                sum += face_area_normals[*t];
+            }
+            normals[v] = sum.unit();
+        }
+    }
+
+    // Gets the direction of increasing u (the tangent) and v (the bitangent) across triangles [first, last); each scaled
+    // by twice the triangle's area, for vertex_tangents(). Triangles with degenerate texture coordinates get zero vectors.
+    template<typename IndexT>
+    inline void face_tangents(
+        const vec3* const positions,
+        const vec2* const texture_coordinates,
+        const IndexT* const indices,
+        vec3* const tangents,
+        vec3* const bitangents,
+        const size_t first,
+        const size_t last
+        )
+    {
+        assert(nullptr != positions && nullptr != texture_coordinates && nullptr != indices);
+        assert(nullptr != tangents && nullptr != bitangents && first <= last);
+        CLG_INSTRUMENT_SCOPE("face_tangents", last - first);
+        for (auto t = first; t < last; t++)
+        {
+            const auto i0 = indices[t * 3 + 0], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+            const auto e1 = positions[i1] - positions[i0];
+            const auto e2 = positions[i2] - positions[i0];
+            const auto d1 = texture_coordinates[i1] - texture_coordinates[i0];
+            const auto d2 = texture_coordinates[i2] - texture_coordinates[i0];
+            const auto determinant = d1.x * d2.y - d2.x * d1.y;
+            if (0.0f == determinant)
+            {
+                tangents[t] = vec3(0.0f, 0.0f, 0.0f);
+                bitangents[t] = vec3(0.0f, 0.0f, 0.0f);
+                continue;
+            }
+
+            // Only the directions matter; the area weights the triangle, not the size of its texture mapping.
+            const auto area = e1.cross(e2).length();
+            const auto orientation = determinant < 0.0f ? -area : area;
+            tangents[t] = (e1 * d2.y - e2 * d1.y).unit() * orientation;
+            bitangents[t] = (e2 * d1.x - e1 * d2.x).unit() * orientation;
+        }
+    }
+
+    // Gets the tangent frame of vertices [first, last) from the face_tangents() of the whole mesh, and the vertex
+    // normals. The tangent is made orthogonal to the normal; w is the handedness, so bitangent = cross(normal, tangent) * w.
+    inline void vertex_tangents(
+        const vertex_triangles& adjacency,
+        const vec3* const face_tangents,
+        const vec3* const face_bitangents,
+        const vec3* const normals,
+        vec4* const tangents,
+        const size_t first,
+        const size_t last
+        )
+    {
+        assert(nullptr != face_tangents && nullptr != face_bitangents && nullptr != normals && nullptr != tangents);
+        assert(first <= last && last <= adjacency.vertex_count());
+        CLG_INSTRUMENT_SCOPE("vertex_tangents", last - first);
+        for (auto v = first; v < last; v++)
+        {
+            vec3 tangent(0.0f, 0.0f, 0.0f);
+            vec3 bitangent(0.0f, 0.0f, 0.0f);
+            for (auto t = adjacency.begin(v); t != adjacency.end(v); t++)
+            {
+                tangent += face_tangents[*t];
+                bitangent += face_bitangents[*t];
+            }
+
+            const auto& normal = normals[v];
+            tangent = (tangent - normal * normal.dot(tangent)).unit();
+            if (0.0f == tangent.length_squared())
+            {
+                // No usable texture mapping; any tangent perpendicular to the normal will do.
+                tangent = (std::abs(normal.x) < 0.9f ? vec3(1.0f, 0.0f, 0.0f) : vec3(0.0f, 1.0f, 0.0f)).cross(normal).unit();
+            }
+            tangents[v] = vec4(tangent, normal.cross(tangent).dot(bitangent) < 0.0f ? -1.0f : 1.0f);
+        }
+    }
+} // namespace clg
+
+#endif
@@ -0,0 +1,411 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGOBB_HPP
+#define CLGOBB_HPP
+
+#ifndef CLGLINALG_HPP
+  #include "clg_linalg.hpp"
+#endif
+
+/*
+ *
+ * Oriented bounding boxes in 2D and 3D; a center, half extents, and an orthonormal basis (the box's axes are the
+ * columns of the basis, and it is always a rotation).
+ *
+ * overlaps() is a separating-axis test: the 4 face axes in 2D; the 6 face axes and 9 edge cross products in 3D. The
+ * cross product axes of nearly parallel edges are padded by a small epsilon, so they can't produce false separations.
+ *
+ * fit_obb() orients the box along the principal axes (the eigenvectors of the covariance) of the points, then fits the
+ * extents to them. It's quick, but not the minimum volume box; uneven point density pulls the axes.
+ *
+ * Example:
+ *  const auto box = clg::fit_obb(vertices, vertex_count).transformed(model);
+ *  clg::obb3::mask_type hits[(n + 63) / 64];
+ *  clg::overlaps(box, others, n, hits);     // one box against many
+ *
+ */
+
+namespace clg { namespace impl
+{
+    template<typename ScalarT, unsigned int Dimensions>
+    class obb
+    {
+    public:
+        using scalar_type = ScalarT;
+        static constexpr unsigned int dimension_count = Dimensions;
+        static constexpr unsigned int corner_count = 1u << Dimensions;
+        using vec_type = vec<scalar_type, dimension_count>;
+        using basis_type = mat<scalar_type, dimension_count, dimension_count>;
+        using transform_type = mat<scalar_type, dimension_count + 1, dimension_count + 1>;
+        using mask_type = uint64_t;
+        static constexpr size_t mask_bits = sizeof(mask_type) * 8;
+        static_assert(2 == dimension_count || 3 == dimension_count, "oriented bounding boxes must be 2D or 3D");
+
+        constexpr obb() { }
+
+        constexpr obb(const obb& original)
+            : _center(original._center)
+            , _half_extents(original._half_extents)
+            , _basis(original._basis) { }
+
+        explicit constexpr obb(const vec_type& center, const vec_type& half_extents)
+            : _center(center)
+            , _half_extents(half_extents) { }
+
+        explicit constexpr obb(const vec_type& center, const vec_type& half_extents, const basis_type& basis)
+            : _center(center)
+            , _half_extents(half_extents)
+            , _basis(basis) { }
+
+        constexpr obb& operator =(const obb& rhs)
+        {
+            if (&rhs == this)
+            {
+                return *this;
+            }
+
+            _center         = rhs._center;
+            _half_extents   = rhs._half_extents;
+            _basis          = rhs._basis;
+
+            return *this;
+        }
+
+        constexpr const vec_type& center() const
+        {
+            return _center;
+        }
+
+        constexpr void center(const vec_type& value)
+        {
+            _center = value;
+        }
+
+        constexpr const vec_type& half_extents() const
+        {
+            return _half_extents;
+        }
+
+        constexpr void half_extents(const vec_type& value)
+        {
+            _half_extents = value;
+        }
+
+        constexpr const basis_type& basis() const
+        {
+            return _basis;
+        }
+
+        constexpr void basis(const basis_type& value)
+        {
+            _basis = value;
+        }
+
+        // gets the unit direction of the box's i-th axis
+        constexpr vec_type axis(const unsigned int i) const
+        {
+            vec_type result;
+            for (auto j = 0u; j < dimension_count; j++)
+            {
+                result[j] = _basis(i, j);
+            }
+            return result;
+        }
+
+        // gets the half size of the axis aligned box around this one
+        vec_type bounds_half_extents() const
+        {
+            vec_type result;
+            for (auto j = 0u; j < dimension_count; j++)
+            {
+                result[j] = scalar_type(0);
+                for (auto i = 0u; i < dimension_count; i++)
+                {
+                    result[j] += std::abs(_basis(i, j)) * _half_extents[i];
+                }
+            }
+            return result;
+        }
+
+        // gets the corners; bit i of a corner's index selects the positive side of axis i
+        void corners(vec_type (&results)[corner_count]) const
+        {
+            for (auto c = 0u; c < corner_count; c++)
+            {
+                results[c] = _center;
+                for (auto i = 0u; i < dimension_count; i++)
+                {
+                    results[c] += axis(i) * ((c >> i) & 1u ? _half_extents[i] : -_half_extents[i]);
+                }
+            }
+        }
+
+        bool contains(const vec_type& point) const
+        {
+            const auto offset = point - _center;
+            for (auto i = 0u; i < dimension_count; i++)
+            {
+                if (std::abs(offset.dot(axis(i))) > _half_extents[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Gets the box around this one after an affine transform. Rotations, translations, and scales are exact; a
+        // shear turns the box into a parallelepiped, so the result is the box around that along its first edges.
+        obb transformed(const transform_type& transform) const
+        {
+            vec_type center;
+            vec_type edges[dimension_count];
+            for (auto j = 0u; j < dimension_count; j++)
+            {
+                center[j] = transform(dimension_count, j);
+                for (auto k = 0u; k < dimension_count; k++)
+                {
+                    center[j] += transform(k, j) * _center[k];
+                }
+            }
+            for (auto i = 0u; i < dimension_count; i++)
+            {
+                const auto direction = axis(i) * _half_extents[i];
+                for (auto j = 0u; j < dimension_count; j++)
+                {
+                    edges[i][j] = scalar_type(0);
+                    for (auto k = 0u; k < dimension_count; k++)
+                    {
+                        edges[i][j] += transform(k, j) * direction[k];
+                    }
+                }
+            }
+
+            // Orthonormalize the transformed edges; degenerate edges fall back to any perpendicular direction.
+            vec_type axes[dimension_count];
+            axes[0] = edges[0].unit();
+            if (scalar_type(0) == axes[0].length_squared())
+            {
+                axes[0][0] = scalar_type(1);
+            }
+            if constexpr (2 == dimension_count)
+            {
+                axes[1] = vec_type(-axes[0].y, axes[0].x);
+            }
+            else
+            {
+                axes[1] = (edges[1] - axes[0] * axes[0].dot(edges[1])).unit();
+                if (scalar_type(0) == axes[1].length_squared())
+                {
+                    axes[1] = (std::abs(axes[0].x) < scalar_type(0.9) ? vec_type(1, 0, 0) : vec_type(0, 1, 0)).cross(axes[0]).unit();
+                }
+                axes[2] = axes[0].cross(axes[1]);
+            }
+
+            obb result;
+            result._center = center;
+            for (auto i = 0u; i < dimension_count; i++)
+            {
+                result._half_extents[i] = scalar_type(0);
+                for (auto k = 0u; k < dimension_count; k++)
+                {
+                    result._half_extents[i] += std::abs(edges[k].dot(axes[i]));
+                }
+                for (auto j = 0u; j < dimension_count; j++)
+                {
+                    result._basis(i, j) = axes[i][j];
+                }
+            }
+            return result;
+        }
+
+        // separating-axis test; touching boxes overlap
+        bool overlaps(const obb& rhs) const
+        {
+            constexpr auto epsilon = std::numeric_limits<scalar_type>::epsilon() * scalar_type(16);
+            const auto& a = _half_extents;
+            const auto& b = rhs._half_extents;
+
+            // The rotation from rhs's frame into this one's, and the offset between them in this frame.
+            scalar_type r[dimension_count][dimension_count];
+            scalar_type abs_r[dimension_count][dimension_count];
+            scalar_type t[dimension_count];
+            const auto offset = rhs._center - _center;
+            for (auto i = 0u; i < dimension_count; i++)
+            {
+                const auto a_axis = axis(i);
+                t[i] = offset.dot(a_axis);
+                for (auto j = 0u; j < dimension_count; j++)
+                {
+                    r[i][j] = a_axis.dot(rhs.axis(j));
+                    abs_r[i][j] = std::abs(r[i][j]) + epsilon;
+                }
+            }
+
+            // this box's axes
+            for (auto i = 0u; i < dimension_count; i++)
+            {
+                auto rb = scalar_type(0);
+                for (auto j = 0u; j < dimension_count; j++)
+                {
+                    rb += b[j] * abs_r[i][j];
+                }
+                if (std::abs(t[i]) > a[i] + rb)
+                {
+                    return false;
+                }
+            }
+
+            // rhs's axes
+            for (auto j = 0u; j < dimension_count; j++)
+            {
+                auto ra = scalar_type(0);
+                auto distance = scalar_type(0);
+                for (auto i = 0u; i < dimension_count; i++)
+                {
+                    ra += a[i] * abs_r[i][j];
+                    distance += t[i] * r[i][j];
+                }
+                if (std::abs(distance) > ra + b[j])
+                {
+                    return false;
+                }
+            }
+
+            if constexpr (3 == dimension_count)
+            {
+                // cross products of each pair of edges
+                for (auto i = 0u; i < 3; i++)
+                {
+                    const auto i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+                    for (auto j = 0u; j < 3; j++)
+                    {
+                        const auto j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+                        const auto ra = a[i1] * abs_r[i2][j] + a[i2] * abs_r[i1][j];
+                        const auto rb = b[j1] * abs_r[i][j2] + b[j2] * abs_r[i][j1];
+                        if (std::abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb)
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+    private:
+        vec_type    _center;
+        vec_type    _half_extents;
+        basis_type  _basis;
+    };
+} // namespace impl
+
+    using obb2 = impl::obb<float, 2>;
+    using obb3 = impl::obb<float, 3>;
+
+    // Fits a box to the points, along their principal axes.
+    template<typename ScalarT, unsigned int Dimensions>
+    inline impl::obb<ScalarT, Dimensions> fit_obb(const impl::vec<ScalarT, Dimensions>* const points, const size_t count)
+    {
+        using obb_type = impl::obb<ScalarT, Dimensions>;
+        using vec_type = typename obb_type::vec_type;
+        assert(nullptr != points && count > 0);
+
+        vec_type mean(ScalarT(0));
+        for (auto n = size_t(0); n < count; n++)
+        {
+            mean += points[n];
+        }
+        mean /= static_cast<ScalarT>(count);
+
+        // The covariance is symmetric; only its lower triangle is accumulated.
+        typename obb_type::basis_type covariance(ScalarT(0));
+        for (auto n = size_t(0); n < count; n++)
+        {
+            const auto d = points[n] - mean;
+            for (auto j = 0u; j < Dimensions; j++)
+            {
+                for (auto i = j; i < Dimensions; i++)
+                {
+                    covariance(j, i) += d[i] * d[j];
+                }
+            }
+        }
+
+        typename obb_type::basis_type basis;
+        if constexpr (2 == Dimensions)
+        {
+            const auto angle = ScalarT(0.5) * std::atan2(ScalarT(2) * covariance(0, 1), covariance(0, 0) - covariance(1, 1));
+            const auto c = std::cos(angle), s = std::sin(angle);
+            basis = typename obb_type::basis_type(c, s, -s, c);
+        }
+        else
+        {
+            vec_type variances;
+            symmetric_eigen(covariance, variances, basis);
+        }
+
+        // Fit the extents along the axes.
+        vec_type low(std::numeric_limits<ScalarT>::max());
+        vec_type high(std::numeric_limits<ScalarT>::lowest());
+        for (auto n = size_t(0); n < count; n++)
+        {
+            const auto d = points[n] - mean;
+            for (auto i = 0u; i < Dimensions; i++)
+            {
+                auto projection = ScalarT(0);
+                for (auto j = 0u; j < Dimensions; j++)
+                {
+                    projection += d[j] * basis(i, j);
+                }
+                low[i] = std::min(low[i], projection);
+                high[i] = std::max(high[i], projection);
+            }
+        }
+
+        auto center = mean;
+        for (auto i = 0u; i < Dimensions; i++)
+        {
+            const auto middle = (low[i] + high[i]) * ScalarT(0.5);
+            for (auto j = 0u; j < Dimensions; j++)
+            {
+                center[j] += basis(i, j) * middle;
+            }
+        }
+        return obb_type(center, (high - low) * ScalarT(0.5), basis);
+    }
+
+    // Sets bit i of mask ((count + 63) / 64 words) for each of the boxes that overlaps box.
+    // Returns the number of boxes that overlap it.
+    template<typename ScalarT, unsigned int Dimensions>
+    inline size_t overlaps(
+        const impl::obb<ScalarT, Dimensions>& box,
+        const impl::obb<ScalarT, Dimensions>* const boxes,
+        const size_t count,
+        typename impl::obb<ScalarT, Dimensions>::mask_type* const mask
+        )
+    {
+        using obb_type = impl::obb<ScalarT, Dimensions>;
+        assert((nullptr != boxes && nullptr != mask) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("obb_overlaps", count);
+        auto hits = size_t(0);
+        for (auto block = size_t(0); block < count; block += obb_type::mask_bits)
+        {
+            const auto block_count = std::min(count - block, obb_type::mask_bits);
+            typename obb_type::mask_type bits = 0;
+            for (auto j = size_t(0); j < block_count; j++)
+            {
+                const auto hit = box.overlaps(boxes[block + j]);
+                bits |= typename obb_type::mask_type(hit) << j;
+                hits += hit ? 1 : 0;
+            }
+            mask[block / obb_type::mask_bits] = bits;
+        }
+        return hits;
+    }
+} // namespace clg
+
+#endif
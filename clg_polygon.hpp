@@ -0,0 +1,350 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGPOLYGON_HPP
+#define CLGPOLYGON_HPP
+
+#ifndef CLGVECTOR_HPP
+  #include "clg_vector.hpp"
+#endif
+
+/*
+ *
+ * Simple 2D polygons, as spans of points; the last point connects back to the first, and isn't repeated.
+ *
+ * Winding is in the math convention, Y up; counter-clockwise polygons have a positive signed area. In raster
+ * coordinates, Y down, they look clockwise on screen. Integer points are computed exactly in 64 bits, as long as their
+ * coordinates stay within +/-2^30.
+ *
+ * polygon_workspace keeps the scratch arrays that the hull, triangulation, and containment tests need, and reuses them
+ * from call to call; so keep one around (per thread) and steady state frames never touch the heap.
+ *
+ *  contains()      even-odd test of many points against one polygon, into a bitmask; each edge is set up once
+ *  convex_hull()   Andrew's monotone chain; O(n log n), counter-clockwise, without collinear points
+ *  triangulate()   ear clipping; n - 2 triangles as indices into the polygon, wound like the polygon
+ *
+ * Example:
+ *  clg::polygon_workspace scratch;
+ *  ...
+ *  const auto triangle_count = scratch.triangulate(outline, outline_count, indices);   // 3 * (outline_count - 2) indices
+ *  const auto hits = scratch.contains(outline, outline_count, cursors, cursor_count, cursor_inside);
+ *
+ */
+
+namespace clg
+{
+    enum class polygon_winding
+    {
+        counter_clockwise,
+        clockwise,
+        degenerate,     // no area
+    };
+
+namespace impl
+{
+    // Integer coordinates are multiplied in 64 bits, so the cross products are exact.
+    template<typename ScalarT>
+    using polygon_compute_type = std::conditional_t<std::is_floating_point_v<ScalarT>, ScalarT, int64_t>;
+
+    // Twice the signed area of the triangle ( o, a, b ); positive when it turns counter-clockwise.
+    template<typename ScalarT>
+    inline polygon_compute_type<ScalarT> polygon_cross(const point<ScalarT>& o, const point<ScalarT>& a, const point<ScalarT>& b)
+    {
+        using compute_type = polygon_compute_type<ScalarT>;
+        return (static_cast<compute_type>(a.x) - static_cast<compute_type>(o.x)) * (static_cast<compute_type>(b.y) - static_cast<compute_type>(o.y)) -
+            (static_cast<compute_type>(a.y) - static_cast<compute_type>(o.y)) * (static_cast<compute_type>(b.x) - static_cast<compute_type>(o.x));
+    }
+
+    template<typename ScalarT>
+    class polygon_workspace
+    {
+    public:
+        using scalar_type   = ScalarT;
+        using point_type    = point<scalar_type>;
+        using compute_type  = polygon_compute_type<scalar_type>;
+        using mask_type     = uint64_t;
+
+        static constexpr size_t mask_bits = sizeof(mask_type) * 8;
+
+        // Tests count points against a polygon, by the even-odd rule, setting bit i of inside ((count + 63) / 64 words)
+        // for those inside it. Points right on the boundary may land either way.
+        // Returns the number of points inside.
+        size_t contains(
+            const point_type* const polygon,
+            const size_t polygon_count,
+            const point_type* const points,
+            const size_t count,
+            mask_type* const inside
+            )
+        {
+            assert((nullptr != polygon || 0 == polygon_count) && ((nullptr != points && nullptr != inside) || 0 == count));
+            CLG_INSTRUMENT_SCOPE("polygon_workspace::contains", count);
+
+            // Each edge's start and direction, as columns; so the loop over them is a branch free sum.
+            _edge_x.resize(polygon_count);
+            _edge_y.resize(polygon_count);
+            _edge_dx.resize(polygon_count);
+            _edge_dy.resize(polygon_count);
+            auto min_x = std::numeric_limits<compute_type>::max(), min_y = min_x;
+            auto max_x = std::numeric_limits<compute_type>::lowest(), max_y = max_x;
+            for (auto i = size_t(0); i < polygon_count; i++)
+            {
+                const auto& from = polygon[i];
+                const auto& to = polygon[i + 1 == polygon_count ? 0 : i + 1];
+                _edge_x[i] = static_cast<compute_type>(from.x);
+                _edge_y[i] = static_cast<compute_type>(from.y);
+                _edge_dx[i] = static_cast<compute_type>(to.x) - _edge_x[i];
+                _edge_dy[i] = static_cast<compute_type>(to.y) - _edge_y[i];
+                min_x = std::min(min_x, _edge_x[i]);
+                min_y = std::min(min_y, _edge_y[i]);
+                max_x = std::max(max_x, _edge_x[i]);
+                max_y = std::max(max_y, _edge_y[i]);
+            }
+
+            const auto edge_x = _edge_x.data(), edge_y = _edge_y.data(), edge_dx = _edge_dx.data(), edge_dy = _edge_dy.data();
+            auto hits = size_t(0);
+            for (auto block = size_t(0); block < count; block += mask_bits)
+            {
+                const auto block_count = std::min(count - block, mask_bits);
+                mask_type bits = 0;
+                for (auto j = size_t(0); j < block_count; j++)
+                {
+                    const auto x = static_cast<compute_type>(points[block + j].x);
+                    const auto y = static_cast<compute_type>(points[block + j].y);
+                    if (x < min_x || x > max_x || y < min_y || y > max_y)
+                    {
+                        continue;
+                    }
+
+                    // Count the edges that cross the horizontal ray to the right of the point.
+                    auto crossings = 0u;
+                    for (auto i = size_t(0); i < polygon_count; i++)
+                    {
+                        const auto spans = (edge_y[i] > y) != (edge_y[i] + edge_dy[i] > y);
+                        const auto side = (y - edge_y[i]) * edge_dx[i] - (x - edge_x[i]) * edge_dy[i];
+                        crossings += static_cast<unsigned int>(spans & ((side > 0) == (edge_dy[i] > 0)));
+                    }
+                    bits |= mask_type(crossings & 1u) << j;
+                }
+                inside[block / mask_bits] = bits;
+                hits += population_count(bits);
+            }
+            return hits;
+        }
+
+        // Gets the convex hull of count points, counter-clockwise from the leftmost (then lowest) one, without
+        // collinear points; hull needs room for count points.
+        // Returns the number of hull points; fewer than three if all the points are collinear.
+        size_t convex_hull(const point_type* const points, const size_t count, point_type* const hull)
+        {
+            assert((nullptr != points && nullptr != hull) || 0 == count);
+            CLG_INSTRUMENT_SCOPE("polygon_workspace::convex_hull", count);
+
+            _sorted.assign(points, points + count);
+            std::sort(_sorted.begin(), _sorted.end(), [](const point_type& lhs, const point_type& rhs)
+            {
+                return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
+            });
+            _sorted.erase(std::unique(_sorted.begin(), _sorted.end()), _sorted.end());
+            if (_sorted.size() < 3)
+            {
+                std::copy(_sorted.begin(), _sorted.end(), hull);
+                return _sorted.size();
+            }
+
+            // The lower chain left to right, then the upper chain back; each only keeps left turns.
+            _chain.resize(_sorted.size() * 2);
+            auto size = size_t(0);
+            for (const auto& p : _sorted)
+            {
+                while (size >= 2 && polygon_cross(_chain[size - 2], _chain[size - 1], p) <= 0)
+                {
+                    size--;
+                }
+                _chain[size++] = p;
+            }
+            const auto lower_size = size + 1;
+            for (auto i = _sorted.size() - 1; i > 0; i--)
+            {
+                const auto& p = _sorted[i - 1];
+                while (size >= lower_size && polygon_cross(_chain[size - 2], _chain[size - 1], p) <= 0)
+                {
+                    size--;
+                }
+                _chain[size++] = p;
+            }
+
+            // The last point is the first one again.
+            std::copy(_chain.begin(), _chain.begin() + (size - 1), hull);
+            return size - 1;
+        }
+
+        // Triangulates a simple polygon of count points, of either winding, by ear clipping; triangles needs room for
+        // 3 * (count - 2) indices. The triangles are wound like the polygon. Degenerate or self-intersecting polygons
+        // still get count - 2 triangles, but some may overlap or have no area.
+        // Returns the number of triangles.
+        template<typename IndexT>
+        size_t triangulate(const point_type* const polygon, const size_t count, IndexT* const triangles)
+        {
+            assert((nullptr != polygon && nullptr != triangles) || count < 3);
+            CLG_INSTRUMENT_SCOPE("polygon_workspace::triangulate", count);
+
+            if (count < 3)
+            {
+                return 0;
+            }
+
+            // A ring of the vertices that are left, and which of them are reflex; only reflex vertices can be inside an
+            // ear, so convex polygons never test any.
+            _orientation = signed_area_twice(polygon, count) < 0 ? -1 : 1;
+            _polygon = polygon;
+            _next.resize(count);
+            _previous.resize(count);
+            _reflex.resize(count);
+            _reflex_count = 0;
+            for (auto i = size_t(0); i < count; i++)
+            {
+                _next[i] = static_cast<uint32_t>(i + 1 == count ? 0 : i + 1);
+                _previous[i] = static_cast<uint32_t>(0 == i ? count - 1 : i - 1);
+            }
+            for (auto i = size_t(0); i < count; i++)
+            {
+                _reflex[i] = static_cast<uint8_t>(reflex(_previous[i], static_cast<uint32_t>(i), _next[i]));
+                _reflex_count += _reflex[i];
+            }
+
+            auto output = triangles;
+            auto vertex = uint32_t(0);
+            auto misses = size_t(0);
+            for (auto remaining = count; remaining > 3; )
+            {
+                const auto previous = _previous[vertex], next = _next[vertex];
+
+                // After a whole lap without an ear, the polygon isn't simple; clip one anyway, so it always finishes.
+                if (misses < remaining && !ear(previous, vertex, next))
+                {
+                    vertex = next;
+                    misses++;
+                    continue;
+                }
+
+                *output++ = static_cast<IndexT>(previous);
+                *output++ = static_cast<IndexT>(vertex);
+                *output++ = static_cast<IndexT>(next);
+                _next[previous] = next;
+                _previous[next] = previous;
+                _reflex_count -= _reflex[vertex];
+                update_reflex(previous);
+                update_reflex(next);
+                remaining--;
+                misses = 0;
+                vertex = next;
+            }
+            *output++ = static_cast<IndexT>(_previous[vertex]);
+            *output++ = static_cast<IndexT>(vertex);
+            *output++ = static_cast<IndexT>(_next[vertex]);
+
+            _polygon = nullptr;
+            return count - 2;
+        }
+
+    private:
+        static compute_type signed_area_twice(const point_type* const polygon, const size_t count)
+        {
+            auto sum = compute_type(0);
+            for (auto i = size_t(1); i + 1 < count; i++)
+            {
+                sum += polygon_cross(polygon[0], polygon[i], polygon[i + 1]);
+            }
+            return sum;
+        }
+
+        // Whether the corner at vertex doesn't turn the polygon's way; collinear corners count, so they block ears.
+        bool reflex(const uint32_t previous, const uint32_t vertex, const uint32_t next) const
+        {
+            return _orientation * polygon_cross(_polygon[previous], _polygon[vertex], _polygon[next]) <= 0;
+        }
+
+        void update_reflex(const uint32_t vertex)
+        {
+            const auto now = reflex(_previous[vertex], vertex, _next[vertex]);
+            _reflex_count += static_cast<size_t>(now) - static_cast<size_t>(_reflex[vertex]);
+            _reflex[vertex] = static_cast<uint8_t>(now);
+        }
+
+        // Whether the triangle ( previous, vertex, next ) can be clipped; the corner is convex, and no other vertex
+        // that's left is inside it or on its edges.
+        bool ear(const uint32_t previous, const uint32_t vertex, const uint32_t next) const
+        {
+            if (_reflex[vertex])
+            {
+                return false;
+            }
+            if (0 == _reflex_count)
+            {
+                return true;
+            }
+
+            const auto& a = _polygon[previous];
+            const auto& b = _polygon[vertex];
+            const auto& c = _polygon[next];
+            for (auto other = _next[next]; other != previous; other = _next[other])
+            {
+                if (!_reflex[other])
+                {
+                    continue;
+                }
+                const auto& p = _polygon[other];
+                if (_orientation * polygon_cross(a, b, p) >= 0 && _orientation * polygon_cross(b, c, p) >= 0 && _orientation * polygon_cross(c, a, p) >= 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::vector<compute_type>   _edge_x;
+        std::vector<compute_type>   _edge_y;
+        std::vector<compute_type>   _edge_dx;
+        std::vector<compute_type>   _edge_dy;
+        std::vector<point_type>     _sorted;
+        std::vector<point_type>     _chain;
+        std::vector<uint32_t>       _next;
+        std::vector<uint32_t>       _previous;
+        std::vector<uint8_t>        _reflex;
+        size_t                      _reflex_count = 0;
+        compute_type                _orientation = 1;
+        const point_type*           _polygon = nullptr;     // only during triangulate()
+    };
+} // namespace impl
+
+    using polygon_workspace     = impl::polygon_workspace<float>;
+    using polygon_workspacei    = impl::polygon_workspace<int_fast32_t>;
+
+    // Gets the signed area of a polygon; positive when it's counter-clockwise. Integer polygons are summed exactly.
+    template<typename ScalarT>
+    inline std::conditional_t<std::is_floating_point_v<ScalarT>, ScalarT, double> polygon_signed_area(const impl::point<ScalarT>* const polygon, const size_t count)
+    {
+        assert(nullptr != polygon || 0 == count);
+
+        // Fanning out from the first point, instead of the origin, keeps far off polygons from losing precision.
+        auto sum = impl::polygon_compute_type<ScalarT>(0);
+        for (auto i = size_t(1); i + 1 < count; i++)
+        {
+            sum += impl::polygon_cross(polygon[0], polygon[i], polygon[i + 1]);
+        }
+        return static_cast<std::conditional_t<std::is_floating_point_v<ScalarT>, ScalarT, double>>(sum) / 2;
+    }
+
+    template<typename ScalarT>
+    inline polygon_winding polygon_winding_order(const impl::point<ScalarT>* const polygon, const size_t count)
+    {
+        const auto area = polygon_signed_area(polygon, count);
+        return area > 0 ? polygon_winding::counter_clockwise : (area < 0 ? polygon_winding::clockwise : polygon_winding::degenerate);
+    }
+} // namespace clg
+
+#endif
@@ -0,0 +1,609 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGQUADTREE_HPP
+#define CLGQUADTREE_HPP
+
+#ifndef CLGRECTANGLE_HPP
+  #include "clg_rectangle.hpp"
+#endif
+
+/*
+ *
+ * Loose quadtree index over points and rects.
+ *
+ * Each node covers a square cell, but accepts any item whose center is in the cell and whose half-extent is no bigger
+ * than half the cell; i.e. the node's "loose" bounds are twice the size of its cell. Because an item only has to stay
+ * inside its node's loose bounds, a moving item is usually updated in place. When it does leave, it climbs to the
+ * nearest ancestor that still holds it and sinks from there, rather than being reinserted from the root.
+ *
+ * Leaves split when they hold more than bucket_size items, down to max_depth. Nodes live in a single flat array and
+ * are allocated and recycled four siblings at a time. Items are pooled too, and identified by the handle returned from
+ * insert(). Queries don't allocate; visitors are called with the handles of the matching items. Queries prune each
+ * node by its cell grown by the largest item below it, so a tree of points prunes as tightly as a plain quadtree.
+ *
+ * Example:
+ *  clg::quadtree<> tree(clg::rect(0.0f, 0.0f, 1024.0f, 1024.0f));
+ *  const auto marker = tree.insert(clg::point(10.0f, 20.0f));
+ *  tree.update(marker, clg::point(11.0f, 20.5f));
+ *  const auto closest = tree.nearest(clg::point(0.0f, 0.0f));
+ *
+ */
+
+namespace clg
+{
+    template<
+        typename ScalarT            = float,
+        typename YAxesPolicy        = StandardYAxis,
+        typename BoundsCheckPolicy  = ClosedIntervals
+        >
+    class quadtree
+    {
+    public:
+        using scalar_type   = ScalarT;
+        using rect_type     = impl::rect<scalar_type, YAxesPolicy, BoundsCheckPolicy>;
+        using point_type    = typename rect_type::point_type;
+        using handle_type   = uint32_t;
+
+        static constexpr handle_type invalid_handle = ~handle_type(0);
+        static constexpr unsigned int max_supported_depth = 24;
+
+        explicit quadtree(const rect_type& bounds, const unsigned int max_depth = 8, const unsigned int bucket_size = 8)
+            : _max_depth(min(max_depth, max_supported_depth))
+            , _bucket_size(max(bucket_size, 1u))
+        {
+            static_assert(std::is_floating_point_v<scalar_type>, "quadtree<> requires a floating-point scalar type");
+            const auto half = max(bounds.width(), bounds.height()) * scalar_type(0.5);
+            _root = node{ bounds.x() + half, bounds.y() + half, half, scalar_type(0), invalid_index, invalid_index, invalid_index, 0u, 0u };
+            clear();
+        }
+
+        // Removes all the items and nodes, but keeps the memory.
+        void clear()
+        {
+            _nodes.clear();
+            _nodes.push_back(_root);
+            _free_nodes.clear();
+            _items.clear();
+            _free_items = invalid_index;
+            _count = 0;
+        }
+
+        size_t size() const
+        {
+            return _count;
+        }
+
+        bool empty() const
+        {
+            return 0 == _count;
+        }
+
+        // Number of nodes in use; including the root.
+        size_t node_count() const
+        {
+            return _nodes.size() - _free_nodes.size() * 4;
+        }
+
+        handle_type insert(const rect_type& bounds)
+        {
+            auto handle = _free_items;
+            if (invalid_index != handle)
+            {
+                _free_items = _items[handle].next;
+            }
+            else
+            {
+                handle = static_cast<handle_type>(_items.size());
+                _items.emplace_back();
+            }
+
+            set_bounds(_items[handle], bounds);
+            sink(0, handle);
+            _count++;
+            return handle;
+        }
+
+        handle_type insert(const point_type& point)
+        {
+            return insert(rect_type(point));
+        }
+
+        void remove(const handle_type handle)
+        {
+            assert(is_live(handle));
+            const auto index = _items[handle].node;
+            unlink(handle);
+            _items[handle].node = invalid_index;
+            _items[handle].next = _free_items;
+            _free_items = handle;
+            _count--;
+            collapse(index);
+        }
+
+        // Moves an item. Stays in its node while it remains inside the node's loose bounds.
+        void update(const handle_type handle, const rect_type& bounds)
+        {
+            assert(is_live(handle));
+            auto& it = _items[handle];
+            set_bounds(it, bounds);
+            if (holds(_nodes[it.node], it))
+            {
+                // It may have grown, so its node and their ancestors may need to reach further.
+                widen_reach(it.node, half_extent(it));
+                return;
+            }
+
+            const auto previous = it.node;
+            unlink(handle);
+            auto ancestor = _nodes[previous].parent;
+            while (invalid_index != ancestor && !holds(_nodes[ancestor], it))
+            {
+                ancestor = _nodes[ancestor].parent;
+            }
+            sink(invalid_index == ancestor ? 0u : ancestor, handle);
+            collapse(previous);
+        }
+
+        void update(const handle_type handle, const point_type& point)
+        {
+            update(handle, rect_type(point));
+        }
+
+        rect_type item_bounds(const handle_type handle) const
+        {
+            assert(is_live(handle));
+            const auto& it = _items[handle];
+            return rect_type(it.x0, it.y0, it.x1 - it.x0, it.y1 - it.y0);
+        }
+
+        // Calls visit(handle_type) for each item that overlaps the area.
+        template<typename visitor_type>
+        void query(const rect_type& area, visitor_type visit) const
+        {
+            const auto x0 = area.x();
+            const auto y0 = area.y();
+            const auto x1 = area.x() + area.width();
+            const auto y1 = area.y() + area.height();
+            for_each_candidate(x0, y0, x1, y1, [&](const handle_type handle)
+            {
+                const auto& it = _items[handle];
+                if (ranges_overlap(it.x0, it.x1, x0, x1) && ranges_overlap(it.y0, it.y1, y0, y1))
+                {
+                    visit(handle);
+                }
+            });
+        }
+
+        void query(const rect_type& area, std::vector<handle_type>& results) const
+        {
+            query(area, [&results](const handle_type handle) { results.push_back(handle); });
+        }
+
+        // Calls visit(handle_type) for each item within radius of the center.
+        template<typename visitor_type>
+        void query_radius(const point_type& center, const scalar_type radius, visitor_type visit) const
+        {
+            const auto radius_squared = radius * radius;
+            for_each_candidate(center.x - radius, center.y - radius, center.x + radius, center.y + radius, [&](const handle_type handle)
+            {
+                if (distance_squared(_items[handle], center) <= radius_squared)
+                {
+                    visit(handle);
+                }
+            });
+        }
+
+        void query_radius(const point_type& center, const scalar_type radius, std::vector<handle_type>& results) const
+        {
+            query_radius(center, radius, [&results](const handle_type handle) { results.push_back(handle); });
+        }
+
+        // Gets the item closest to the point, or invalid_handle if there isn't one within max_distance.
+        handle_type nearest(const point_type& point, const scalar_type max_distance = std::numeric_limits<scalar_type>::max()) const
+        {
+            handle_type result = invalid_handle;
+            k_nearest(point, 1, &result, max_distance);
+            return result;
+        }
+
+        // Gets up to k of the items closest to the point, nearest first. Returns the number of items found.
+        size_t k_nearest(
+            const point_type& point,
+            const size_t k,
+            handle_type* const results,
+            const scalar_type max_distance = std::numeric_limits<scalar_type>::max()
+            ) const
+        {
+            assert(nullptr != results || 0 == k);
+            if (0 == k)
+            {
+                return 0;
+            }
+
+            // results[0, found) is a max-heap on distance while searching.
+            const auto closer = [this, &point](const handle_type lhs, const handle_type rhs)
+            {
+                return distance_squared(_items[lhs], point) < distance_squared(_items[rhs], point);
+            };
+
+            auto found = size_t(0);
+            auto limit = max_distance < std::sqrt(std::numeric_limits<scalar_type>::max()) ?
+                max_distance * max_distance : std::numeric_limits<scalar_type>::max();
+
+            uint32_t stack[stack_capacity];
+            auto top = 0u;
+            stack[top++] = 0;
+            while (0 != top)
+            {
+                const auto index = stack[--top];
+                const auto& n = _nodes[index];
+                if (0 != index && node_distance_squared(n, point) > limit)
+                {
+                    continue;
+                }
+
+                for (auto i = n.first_item; invalid_index != i; i = _items[i].next)
+                {
+                    const auto d = distance_squared(_items[i], point);
+                    if (d > limit)
+                    {
+                        continue;
+                    }
+                    if (found == k)
+                    {
+                        std::pop_heap(results, results + found, closer);
+                        found--;
+                    }
+                    results[found++] = static_cast<handle_type>(i);
+                    std::push_heap(results, results + found, closer);
+                    if (found == k)
+                    {
+                        limit = distance_squared(_items[results[0]], point);
+                    }
+                }
+
+                if (invalid_index == n.first_child)
+                {
+                    continue;
+                }
+
+                // Push the farthest children first, so the nearest is searched first and tightens the limit.
+                uint32_t order[4];
+                scalar_type distances[4];
+                auto count = 0u;
+                for (auto c = n.first_child; c < n.first_child + 4; c++)
+                {
+                    if (is_empty_branch(_nodes[c]))
+                    {
+                        continue;
+                    }
+                    const auto d = node_distance_squared(_nodes[c], point);
+                    if (d > limit)
+                    {
+                        continue;
+                    }
+                    auto j = count++;
+                    for (; j > 0 && distances[j - 1] < d; j--)
+                    {
+                        order[j] = order[j - 1];
+                        distances[j] = distances[j - 1];
+                    }
+                    order[j] = c;
+                    distances[j] = d;
+                }
+                for (auto j = 0u; j < count; j++)
+                {
+                    stack[top++] = order[j];
+                }
+            }
+
+            std::sort_heap(results, results + found, closer);
+            return found;
+        }
+
+    private:
+        static constexpr uint32_t invalid_index = ~uint32_t(0);
+        static constexpr unsigned int stack_capacity = 3 * max_supported_depth + 4;
+
+        struct node
+        {
+            scalar_type cx;             // center of the cell
+            scalar_type cy;
+            scalar_type half;           // half the width of the cell; the loose bounds are twice the cell's size
+            scalar_type reach;          // greatest half-extent of the items below, which only grows; at most half below the root
+            uint32_t    parent;
+            uint32_t    first_child;    // the four children are consecutive
+            uint32_t    first_item;     // intrusive, doubly-linked, list of items
+            uint32_t    item_count;     // items in this node and all its descendants
+            uint32_t    depth;
+        };
+
+        struct item
+        {
+            scalar_type x0, y0, x1, y1;
+            uint32_t    node = invalid_index;
+            uint32_t    next = invalid_index;
+            uint32_t    prev = invalid_index;
+        };
+
+        // Calls test(handle_type) for each item in a node whose cell, grown by its reach, touches the area.
+        template<typename test_type>
+        void for_each_candidate(const scalar_type x0, const scalar_type y0, const scalar_type x1, const scalar_type y1, test_type test) const
+        {
+            uint32_t stack[stack_capacity];
+            auto top = 0u;
+            stack[top++] = 0;
+            while (0 != top)
+            {
+                const auto& n = _nodes[stack[--top]];
+                for (auto i = n.first_item; invalid_index != i; i = _items[i].next)
+                {
+                    test(static_cast<handle_type>(i));
+                }
+                if (invalid_index == n.first_child)
+                {
+                    continue;
+                }
+                for (auto c = n.first_child; c < n.first_child + 4; c++)
+                {
+                    const auto& child = _nodes[c];
+                    const auto extent = child.half + child.reach;
+                    if (!is_empty_branch(child) &&
+                        !(child.cx + extent < x0 || x1 < child.cx - extent || child.cy + extent < y0 || y1 < child.cy - extent))
+                    {
+                        stack[top++] = c;
+                    }
+                }
+            }
+        }
+
+        static constexpr bool ranges_overlap(const scalar_type low0, const scalar_type high0, const scalar_type low1, const scalar_type high1)
+        {
+            if constexpr (std::is_same_v<BoundsCheckPolicy, ClosedIntervals>)
+            {
+                return !(high0 < low1 || high1 < low0); // NOTE: Inclusive coordinates.
+            }
+            else
+            {
+                // NOTE: Exclusive coordinates; an empty range (e.g. a point) is tested as a coordinate instead.
+                if (low0 == high0)
+                {
+                    return low1 == high1 ? low0 == low1 : (low1 <= low0 && low0 < high1);
+                }
+                if (low1 == high1)
+                {
+                    return low0 <= low1 && low1 < high0;
+                }
+                return low0 < high1 && low1 < high0;
+            }
+        }
+
+        static constexpr scalar_type distance_squared(const item& it, const point_type& point)
+        {
+            const auto dx = max(max(it.x0 - point.x, point.x - it.x1), scalar_type(0));
+            const auto dy = max(max(it.y0 - point.y, point.y - it.y1), scalar_type(0));
+            return dx * dx + dy * dy;
+        }
+
+        static constexpr scalar_type node_distance_squared(const node& n, const point_type& point)
+        {
+            const auto extent = n.half + n.reach;
+            const auto dx = max(std::abs(point.x - n.cx) - extent, scalar_type(0));
+            const auto dy = max(std::abs(point.y - n.cy) - extent, scalar_type(0));
+            return dx * dx + dy * dy;
+        }
+
+        static constexpr bool is_empty_branch(const node& n)
+        {
+            return 0 == n.item_count;
+        }
+
+        static void set_bounds(item& it, const rect_type& bounds)
+        {
+            it.x0 = bounds.x();
+            it.y0 = bounds.y();
+            it.x1 = bounds.x() + bounds.width();
+            it.y1 = bounds.y() + bounds.height();
+        }
+
+        // Whether the item is inside the node's loose bounds. The root holds everything that can't sink below it.
+        static constexpr bool holds(const node& n, const item& it)
+        {
+            if (invalid_index == n.parent)
+            {
+                return invalid_index == n.first_child || !fits(n.half * scalar_type(0.5), it) || !centered_in(n, it);
+            }
+            return fits(n.half, it) && centered_in(n, it);
+        }
+
+        static constexpr bool centered_in(const node& n, const item& it)
+        {
+            return std::abs((it.x0 + it.x1) * scalar_type(0.5) - n.cx) <= n.half &&
+                std::abs((it.y0 + it.y1) * scalar_type(0.5) - n.cy) <= n.half;
+        }
+
+        static constexpr bool fits(const scalar_type half, const item& it)
+        {
+            return (it.x1 - it.x0) <= half * scalar_type(2) && (it.y1 - it.y0) <= half * scalar_type(2);
+        }
+
+        bool is_live(const handle_type handle) const
+        {
+            return handle < _items.size() && invalid_index != _items[handle].node;
+        }
+
+        static constexpr uint32_t quadrant(const node& n, const item& it)
+        {
+            const auto x = (it.x0 + it.x1) * scalar_type(0.5);
+            const auto y = (it.y0 + it.y1) * scalar_type(0.5);
+            return (n.cx <= x ? 1u : 0u) | (n.cy <= y ? 2u : 0u);
+        }
+
+        void link(const uint32_t index, const handle_type handle)
+        {
+            auto& it = _items[handle];
+            auto& n = _nodes[index];
+            it.node = index;
+            it.prev = invalid_index;
+            it.next = n.first_item;
+            if (invalid_index != n.first_item)
+            {
+                _items[n.first_item].prev = handle;
+            }
+            n.first_item = handle;
+            const auto reach = half_extent(it);
+            for (auto i = index; invalid_index != i; i = _nodes[i].parent)
+            {
+                _nodes[i].item_count++;
+                _nodes[i].reach = max(_nodes[i].reach, reach);
+            }
+        }
+
+        static constexpr scalar_type half_extent(const item& it)
+        {
+            return max(it.x1 - it.x0, it.y1 - it.y0) * scalar_type(0.5);
+        }
+
+        // An ancestor's reach is never less than its children's, so this stops at the first node reaching that far.
+        void widen_reach(const uint32_t index, const scalar_type reach)
+        {
+            for (auto i = index; invalid_index != i && _nodes[i].reach < reach; i = _nodes[i].parent)
+            {
+                _nodes[i].reach = reach;
+            }
+        }
+
+        void unlink(const handle_type handle)
+        {
+            auto& it = _items[handle];
+            auto& n = _nodes[it.node];
+            if (invalid_index != it.prev)
+            {
+                _items[it.prev].next = it.next;
+            }
+            else
+            {
+                n.first_item = it.next;
+            }
+            if (invalid_index != it.next)
+            {
+                _items[it.next].prev = it.prev;
+            }
+            for (auto i = it.node; invalid_index != i; i = _nodes[i].parent)
+            {
+                _nodes[i].item_count--;
+            }
+        }
+
+        // Inserts the item into the deepest node, at or below index, that can hold it.
+        void sink(uint32_t index, const handle_type handle)
+        {
+            for (;;)
+            {
+                const auto& n = _nodes[index];
+                const auto child_half = n.half * scalar_type(0.5);
+                // NOTE: Items centered outside the root's cell stay in the root.
+                if (n.depth >= _max_depth || !fits(child_half, _items[handle]) || !centered_in(n, _items[handle]))
+                {
+                    break;
+                }
+                if (invalid_index == n.first_child)
+                {
+                    if (n.item_count < _bucket_size)
+                    {
+                        break;
+                    }
+                    split(index);
+                }
+                index = _nodes[index].first_child + quadrant(_nodes[index], _items[handle]);
+            }
+            link(index, handle);
+        }
+
+        void split(const uint32_t index)
+        {
+            uint32_t first;
+            if (!_free_nodes.empty())
+            {
+                first = _free_nodes.back();
+                _free_nodes.pop_back();
+            }
+            else
+            {
+                first = static_cast<uint32_t>(_nodes.size());
+                _nodes.resize(_nodes.size() + 4);
+            }
+
+            const auto n = _nodes[index];
+            const auto child_half = n.half * scalar_type(0.5);
+            for (auto q = 0u; q < 4; q++)
+            {
+                const auto cx = n.cx + ((q & 1u) ? child_half : -child_half);
+                const auto cy = n.cy + ((q & 2u) ? child_half : -child_half);
+                _nodes[first + q] = node{ cx, cy, child_half, scalar_type(0), index, invalid_index, invalid_index, 0u, n.depth + 1u };
+            }
+            _nodes[index].first_child = first;
+
+            // Push down the items that fit in the children.
+            for (auto i = n.first_item; invalid_index != i;)
+            {
+                const auto next = _items[i].next;
+                if (fits(child_half, _items[i]) && centered_in(n, _items[i]))
+                {
+                    unlink(i);
+                    sink(first + quadrant(n, _items[i]), i);
+                }
+                i = next;
+            }
+        }
+
+        // Merges the children of index's ancestors back into them, while they fit in one bucket.
+        void collapse(uint32_t index)
+        {
+            for (index = _nodes[index].parent; invalid_index != index; index = _nodes[index].parent)
+            {
+                auto& n = _nodes[index];
+                if (invalid_index == n.first_child || n.item_count > _bucket_size)
+                {
+                    return;
+                }
+
+                // Everything below fits in one bucket again; pull it up into this node.
+                for (auto c = n.first_child; c < n.first_child + 4; c++)
+                {
+                    if (invalid_index != _nodes[c].first_child)
+                    {
+                        return;
+                    }
+                }
+                const auto first = n.first_child;
+                for (auto c = first; c < first + 4; c++)
+                {
+                    while (invalid_index != _nodes[c].first_item)
+                    {
+                        const auto handle = _nodes[c].first_item;
+                        unlink(handle);
+                        link(index, handle);
+                    }
+                }
+                _nodes[index].first_child = invalid_index;
+                _free_nodes.push_back(first);
+            }
+        }
+
+        node                        _root;
+        unsigned int                _max_depth;
+        unsigned int                _bucket_size;
+        std::vector<node>           _nodes;
+        std::vector<uint32_t>       _free_nodes;    // first index of each free block of four siblings
+        std::vector<item>           _items;
+        handle_type                 _free_items = invalid_index;
+        size_t                      _count = 0;
+    };
+} // namespace clg
+
+#endif
@@ -0,0 +1,289 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGRECTARRAY_HPP
+#define CLGRECTARRAY_HPP
+
+#ifndef CLGRECTANGLE_HPP
+  #include "clg_rectangle.hpp"
+#endif
+
+/*
+ *
+ * Structure-of-arrays storage for many rects, with batch hit-testing kernels.
+ *
+ * Each rect is stored as four precomputed edge lanes: the least and greatest x, and the least and greatest y. The
+ * YAxesPolicy doesn't change the edges; the location of a rect is its least y corner either way. The tests in the
+ * kernels are plain comparisons on contiguous arrays, written so the compiler vectorizes them, and produce one bit
+ * per rect in blocks of 64 rects.
+ *
+ * The BoundsCheckPolicy decides whether the greatest edges are included:
+ *  ClosedIntervals     - x0 <= x <= x1 and y0 <= y <= y1
+ *  RightOpenIntervals  - x0 <= x <  x1 and y0 <= y <  y1
+ *
+ * For z-ordered hit-testing keep the rects in draw order; last_containing() then finds the topmost rect under the
+ * pointer. Use first_containing() when the rects are sorted front to back instead.
+ *
+ */
+
+namespace clg
+{
+    template<
+        typename ScalarT,
+        typename YAxesPolicy        = StandardYAxis,
+        typename BoundsCheckPolicy  = ClosedIntervals
+        >
+    class rect_array
+    {
+    public:
+        using scalar_type   = ScalarT;
+        using rect_type     = impl::rect<scalar_type, YAxesPolicy, BoundsCheckPolicy>;
+        using point_type    = typename rect_type::point_type;
+        using mask_type     = uint64_t;
+
+        static constexpr size_t npos = ~size_t(0);
+        static constexpr size_t mask_bits = sizeof(mask_type) * 8;
+
+        rect_array() { }
+
+        explicit rect_array(const rect_type* const rectangles, const size_t count)
+        {
+            assign(rectangles, count);
+        }
+
+        void assign(const rect_type* const rectangles, const size_t count)
+        {
+            assert(nullptr != rectangles || 0 == count);
+            resize(count);
+            for (auto i = size_t(0); i < count; i++)
+            {
+                set(i, rectangles[i]);
+            }
+        }
+
+        void reserve(const size_t count)
+        {
+            _x0.reserve(count);
+            _y0.reserve(count);
+            _x1.reserve(count);
+            _y1.reserve(count);
+        }
+
+        void resize(const size_t count)
+        {
+            _x0.resize(count);
+            _y0.resize(count);
+            _x1.resize(count);
+            _y1.resize(count);
+        }
+
+        void clear()
+        {
+            resize(0);
+        }
+
+        void push_back(const rect_type& rectangle)
+        {
+            _x0.push_back(rectangle.x());
+            _y0.push_back(rectangle.y());
+            _x1.push_back(rectangle.x() + rectangle.width());
+            _y1.push_back(rectangle.y() + rectangle.height());
+        }
+
+        void set(const size_t index, const rect_type& rectangle)
+        {
+            assert(index < size());
+            _x0[index] = rectangle.x();
+            _y0[index] = rectangle.y();
+            _x1[index] = rectangle.x() + rectangle.width();
+            _y1[index] = rectangle.y() + rectangle.height();
+        }
+
+        rect_type get(const size_t index) const
+        {
+            assert(index < size());
+            return rect_type(_x0[index], _y0[index], _x1[index] - _x0[index], _y1[index] - _y0[index]);
+        }
+
+        size_t size() const
+        {
+            return _x0.size();
+        }
+
+        bool empty() const
+        {
+            return _x0.empty();
+        }
+
+        // Number of mask_type words needed to hold one bit per rect.
+        size_t mask_word_count() const
+        {
+            return (size() + mask_bits - 1) / mask_bits;
+        }
+
+        // edge lanes
+        const scalar_type* x0() const { return _x0.data(); }
+        const scalar_type* y0() const { return _y0.data(); }
+        const scalar_type* x1() const { return _x1.data(); }
+        const scalar_type* y1() const { return _y1.data(); }
+
+        // Sets bit i of mask (mask_word_count() words) for each rect i that contains the point.
+        // Returns the number of rects that contain the point.
+        size_t contains(const point_type& point, mask_type* const mask) const
+        {
+            assert(nullptr != mask || empty());
+            auto hits = size_t(0);
+            for (auto block = size_t(0); block < size(); block += mask_bits)
+            {
+                const auto bits = contains_block(point, block);
+                mask[block / mask_bits] = bits;
+                hits += population_count(bits);
+            }
+            return hits;
+        }
+
+        // Sets bit i of mask (mask_word_count() words) for each rect i that overlaps the rect.
+        // Returns the number of rects that overlap it.
+        size_t overlaps(const rect_type& rectangle, mask_type* const mask) const
+        {
+            assert(nullptr != mask || empty());
+            auto hits = size_t(0);
+            for (auto block = size_t(0); block < size(); block += mask_bits)
+            {
+                const auto bits = overlaps_block(rectangle, block);
+                mask[block / mask_bits] = bits;
+                hits += population_count(bits);
+            }
+            return hits;
+        }
+
+        // Gets the index of the first rect that contains the point, or npos.
+        size_t first_containing(const point_type& point) const
+        {
+            for (auto block = size_t(0); block < size(); block += mask_bits)
+            {
+                const auto bits = contains_block(point, block);
+                if (0 != bits)
+                {
+                    return block + lowest_set_bit_index(bits);
+                }
+            }
+            return npos;
+        }
+
+        // Gets the index of the last rect that contains the point, or npos.
+        size_t last_containing(const point_type& point) const
+        {
+            for (auto block = mask_word_count() * mask_bits; block > 0;)
+            {
+                block -= mask_bits;
+                const auto bits = contains_block(point, block);
+                if (0 != bits)
+                {
+                    return block + highest_set_bit_index(bits);
+                }
+            }
+            return npos;
+        }
+
+        // Gets the index of the first rect that overlaps the rect, or npos.
+        size_t first_overlapping(const rect_type& rectangle) const
+        {
+            for (auto block = size_t(0); block < size(); block += mask_bits)
+            {
+                const auto bits = overlaps_block(rectangle, block);
+                if (0 != bits)
+                {
+                    return block + lowest_set_bit_index(bits);
+                }
+            }
+            return npos;
+        }
+
+        // Gets the index of the last rect that overlaps the rect, or npos.
+        size_t last_overlapping(const rect_type& rectangle) const
+        {
+            for (auto block = mask_word_count() * mask_bits; block > 0;)
+            {
+                block -= mask_bits;
+                const auto bits = overlaps_block(rectangle, block);
+                if (0 != bits)
+                {
+                    return block + highest_set_bit_index(bits);
+                }
+            }
+            return npos;
+        }
+
+    private:
+        mask_type contains_block(const point_type& point, const size_t block) const
+        {
+            const auto count = min(size() - block, mask_bits);
+            const auto* const x0 = _x0.data() + block;
+            const auto* const y0 = _y0.data() + block;
+            const auto* const x1 = _x1.data() + block;
+            const auto* const y1 = _y1.data() + block;
+            const auto px = point.x;
+            const auto py = point.y;
+
+            mask_type bits = 0;
+            for (auto j = size_t(0); j < count; j++)
+            {
+                if constexpr (std::is_same_v<BoundsCheckPolicy, ClosedIntervals>)
+                {
+                    // NOTE: Inclusive coordinates.
+                    const bool hit = (x0[j] <= px) & (px <= x1[j]) & (y0[j] <= py) & (py <= y1[j]);
+                    bits |= mask_type(hit) << j;
+                }
+                else
+                {
+                    // NOTE: Exclusive coordinates.
+                    const bool hit = (x0[j] <= px) & (px < x1[j]) & (y0[j] <= py) & (py < y1[j]);
+                    bits |= mask_type(hit) << j;
+                }
+            }
+            return bits;
+        }
+
+        mask_type overlaps_block(const rect_type& rectangle, const size_t block) const
+        {
+            const auto count = min(size() - block, mask_bits);
+            const auto* const x0 = _x0.data() + block;
+            const auto* const y0 = _y0.data() + block;
+            const auto* const x1 = _x1.data() + block;
+            const auto* const y1 = _y1.data() + block;
+            const auto rx0 = rectangle.x();
+            const auto ry0 = rectangle.y();
+            const auto rx1 = rectangle.x() + rectangle.width();
+            const auto ry1 = rectangle.y() + rectangle.height();
+
+            mask_type bits = 0;
+            for (auto j = size_t(0); j < count; j++)
+            {
+                if constexpr (std::is_same_v<BoundsCheckPolicy, ClosedIntervals>)
+                {
+                    // NOTE: Inclusive coordinates.
+                    const bool hit = (x0[j] <= rx1) & (rx0 <= x1[j]) & (y0[j] <= ry1) & (ry0 <= y1[j]);
+                    bits |= mask_type(hit) << j;
+                }
+                else
+                {
+                    // NOTE: Exclusive coordinates.
+                    const bool hit = (x0[j] < rx1) & (rx0 < x1[j]) & (y0[j] < ry1) & (ry0 < y1[j]);
+                    bits |= mask_type(hit) << j;
+                }
+            }
+            return bits;
+        }
+
+        std::vector<scalar_type>    _x0;
+        std::vector<scalar_type>    _y0;
+        std::vector<scalar_type>    _x1;
+        std::vector<scalar_type>    _y1;
+    };
+} // namespace clg
+
+#endif
@@ -0,0 +1,277 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGRECTPACKER_HPP
+#define CLGRECTPACKER_HPP
+
+#ifndef CLGRECTANGLE_HPP
+  #include "clg_rectangle.hpp"
+#endif
+
+/*
+ *
+ * Skyline bin packer for building texture atlases (glyphs, sprites, etc.)
+ *
+ * The packer keeps a "skyline" of horizontal segments across the width of the bin. Each segment records how far down
+ * the bin has been filled at that span of columns. A new rectangle is placed where it ends up closest to the top of
+ * the bin (bottom-left heuristic, in raster coordinates), with ties going to the narrowest segment to limit waste.
+ *
+ * Placements are raster rects: the origin is the upper-left corner of the bin and y increases downward. Because a
+ * growing bin only extends to the right and downward, every placement made before the bin grows remains valid.
+ *
+ * Example:
+ *  clg::skyline_packer<> packer(clg::sizevui(256, 256), clg::sizevui(4096, 4096));
+ *  clg::raster_rectui glyph;
+ *  if (packer.insert(clg::sizevui(12, 18), glyph)) { ...upload glyph bitmap at glyph.location()... }
+ *
+ */
+
+namespace clg
+{
+    template<typename ScalarT = uint_fast32_t>
+    class skyline_packer
+    {
+    public:
+        using scalar_type   = ScalarT;
+        using size_type     = impl::size<scalar_type>;
+        using rect_type     = impl::rect<scalar_type, InvertedYAxis, RightOpenIntervals>;
+
+        // Fixed size bin.
+        explicit skyline_packer(const size_type& bin_size)
+            : skyline_packer(bin_size, bin_size) { }
+
+        // Growing bin; starts at bin_size and doubles a dimension at a time until max_size is reached.
+        explicit skyline_packer(const size_type& bin_size, const size_type& max_size)
+            : _bin_size(bin_size)
+            , _max_size(max(bin_size.width, max_size.width), max(bin_size.height, max_size.height))
+        {
+            clear();
+        }
+
+        // Empties the bin, without releasing memory, but keeps the current bin size.
+        void clear()
+        {
+            _skyline.clear();
+            _skyline.push_back(segment{ scalar_type(0), scalar_type(0), _bin_size.width });
+            _used_area = 0;
+        }
+
+        constexpr const size_type& bin_size() const
+        {
+            return _bin_size;
+        }
+
+        constexpr const size_type& max_size() const
+        {
+            return _max_size;
+        }
+
+        // Ratio of the area covered by placed rects to the area of the bin.
+        float occupancy() const
+        {
+            const auto bin_area = static_cast<double>(_bin_size.width) * static_cast<double>(_bin_size.height);
+            return 0.0 < bin_area ? static_cast<float>(static_cast<double>(_used_area) / bin_area) : 0.0f;
+        }
+
+        // Places a single rectangle (incremental insertion, for dynamic glyph caches).
+        // Returns false, and leaves placement untouched, if the rect won't fit even after growing the bin.
+        bool insert(const size_type& size, rect_type& placement)
+        {
+            if (size.width <= scalar_type(0) || size.height <= scalar_type(0))
+            {
+                placement = rect_type(scalar_type(0), scalar_type(0), size.width, size.height);
+                return true;
+            }
+
+            for (;;)
+            {
+                scalar_type y = 0;
+                const auto index = find_position(size, y);
+                if (index != npos)
+                {
+                    placement = rect_type(_skyline[index].x, y, size.width, size.height);
+                    add_skyline_level(index, placement);
+                    _used_area += static_cast<unsigned long long>(size.width) * static_cast<unsigned long long>(size.height);
+                    return true;
+                }
+
+                if (!grow(size))
+                {
+                    return false;
+                }
+            }
+        }
+
+        // Places an array of rectangles. Sizes are inserted tallest first which packs much tighter than arrival order.
+        // placements[i] receives the location of sizes[i]; the rects that didn't fit have their placement set to an
+        // empty rect at the origin. Returns the count of rects that were placed.
+        size_t insert(const size_type* const sizes, const size_t count, rect_type* const placements)
+        {
+            assert((nullptr != sizes && nullptr != placements) || 0 == count);
+            CLG_INSTRUMENT_SCOPE("rect_packer::insert", count);
+
+            _order.resize(count);
+            for (auto i = size_t(0); i < count; i++)
+            {
+                _order[i] = i;
+            }
+            std::sort(_order.begin(), _order.end(), [sizes](const size_t lhs, const size_t rhs)
+            {
+                if (sizes[lhs].height != sizes[rhs].height)
+                {
+                    return sizes[rhs].height < sizes[lhs].height;
+                }
+                return sizes[rhs].width < sizes[lhs].width;
+            });
+
+            auto placed = size_t(0);
+            for (const auto i : _order)
+            {
+                if (insert(sizes[i], placements[i]))
+                {
+                    placed++;
+                }
+                else
+                {
+                    placements[i] = rect_type();
+                }
+            }
+            return placed;
+        }
+
+    private:
+        struct segment
+        {
+            scalar_type x;
+            scalar_type y;      // the first free row beneath this segment
+            scalar_type width;
+        };
+
+        static constexpr size_t npos = ~size_t(0);
+
+        // Gets the lowest y a rect of the given width can rest at when its left edge is at segment[index].
+        // Returns false if it runs off the right side of the bin.
+        bool fit(const size_t index, const size_type& size, scalar_type& y) const
+        {
+            const auto x = _skyline[index].x;
+            if (_bin_size.width - x < size.width)
+            {
+                return false;
+            }
+
+            y = _skyline[index].y;
+            auto width_left = size.width;
+            for (auto i = index; width_left > scalar_type(0); i++)
+            {
+                y = max(y, _skyline[i].y);
+                if (_bin_size.height - y < size.height)
+                {
+                    return false;
+                }
+                width_left = _skyline[i].width < width_left ? width_left - _skyline[i].width : scalar_type(0);
+            }
+            return true;
+        }
+
+        size_t find_position(const size_type& size, scalar_type& best_y) const
+        {
+            auto best_index = npos;
+            auto best_bottom = scalar_type(0);
+            auto best_width = scalar_type(0);
+            for (auto i = size_t(0); i < _skyline.size(); i++)
+            {
+                scalar_type y;
+                if (!fit(i, size, y))
+                {
+                    continue;
+                }
+
+                const auto bottom = y + size.height;
+                if (npos == best_index || bottom < best_bottom || (bottom == best_bottom && _skyline[i].width < best_width))
+                {
+                    best_index = i;
+                    best_bottom = bottom;
+                    best_width = _skyline[i].width;
+                    best_y = y;
+                }
+            }
+            return best_index;
+        }
+
+        void add_skyline_level(const size_t index, const rect_type& placement)
+        {
+            _skyline.insert(_skyline.begin() + index, segment{ placement.x(), placement.bottom(), placement.width() });
+
+            // Shrink or remove the segments now hidden beneath the new one.
+            const auto right = placement.right();
+            for (auto i = index + 1; i < _skyline.size();)
+            {
+                auto& s = _skyline[i];
+                if (right <= s.x)
+                {
+                    break;
+                }
+
+                const auto s_right = s.x + s.width;
+                if (s_right <= right)
+                {
+                    _skyline.erase(_skyline.begin() + i);
+                    continue;
+                }
+
+                s.width = s_right - right;
+                s.x = right;
+                break;
+            }
+
+            // Merge neighbors resting at the same level.
+            for (auto i = size_t(0); i + 1 < _skyline.size();)
+            {
+                if (_skyline[i].y == _skyline[i + 1].y)
+                {
+                    _skyline[i].width += _skyline[i + 1].width;
+                    _skyline.erase(_skyline.begin() + i + 1);
+                    continue;
+                }
+                i++;
+            }
+        }
+
+        // Doubles the narrower dimension (to keep the atlas square-ish) until the rect could fit, or the bin can't grow.
+        bool grow(const size_type& size)
+        {
+            const auto can_grow_width = _bin_size.width < _max_size.width;
+            const auto can_grow_height = _bin_size.height < _max_size.height;
+            if (!can_grow_width && !can_grow_height)
+            {
+                return false;
+            }
+
+            const auto wider = [this]() { return min(_max_size.width, round_up_to_nearest_power_of_two(_bin_size.width + scalar_type(1))); };
+            const auto taller = [this]() { return min(_max_size.height, round_up_to_nearest_power_of_two(_bin_size.height + scalar_type(1))); };
+
+            if (can_grow_width && (!can_grow_height || _bin_size.width <= _bin_size.height || _bin_size.width < size.width))
+            {
+                const auto old_width = _bin_size.width;
+                _bin_size.width = wider();
+                _skyline.push_back(segment{ old_width, scalar_type(0), _bin_size.width - old_width });
+            }
+            else
+            {
+                _bin_size.height = taller();
+            }
+            return true;
+        }
+
+        size_type               _bin_size;
+        size_type               _max_size;
+        std::vector<segment>    _skyline;
+        std::vector<size_t>     _order;
+        unsigned long long      _used_area = 0;
+    };
+} // namespace clg
+
+#endif
@@ -222,6 +222,7 @@ namespace impl
 
         constexpr bool contains(const point_type& point) const
         {
+            CLG_INSTRUMENT_COUNT(rect_contains);
             if constexpr (std::is_same_v<BoundsCheckPolicy, ClosedIntervals>)
             {
                 if (point.x < _location.x || point.y < _location.y)
@@ -254,6 +255,7 @@ namespace impl
 
         constexpr bool overlaps(const rect& rectangle) const
         {
+            CLG_INSTRUMENT_COUNT(rect_overlaps);
             if constexpr (std::is_same_v<BoundsCheckPolicy, ClosedIntervals>)
             {
                  // NOTE: Inclusive coordinate checks.
@@ -291,6 +293,90 @@ namespace impl
             return rect(x, y, w, h);
         }
 
+        // Gets the area shared by two rects. Returns false, and an empty rect, if they don't overlap.
+        // NOTE: With ClosedIntervals rects that only touch do overlap, and their intersection is a zero width or height rect.
+        constexpr bool intersect(const rect& rectangle, rect& intersection) const
+        {
+            CLG_INSTRUMENT_COUNT(rect_intersect);
+            const auto x0 = max(_location.x, rectangle._location.x);
+            const auto y0 = max(_location.y, rectangle._location.y);
+            const auto x1 = min(_location.x + _size.width,  rectangle._location.x + rectangle._size.width );
+            const auto y1 = min(_location.y + _size.height, rectangle._location.y + rectangle._size.height);
+
+            if constexpr (std::is_same_v<BoundsCheckPolicy, ClosedIntervals>)
+            {
+                if (x1 < x0 || y1 < y0) // NOTE: Inclusive coordinates.
+                {
+                    intersection = rect();
+                    return false;
+                }
+            }
+            else
+            {
+                if (x1 <= x0 || y1 <= y0) // NOTE: Exclusive coordinates.
+                {
+                    intersection = rect();
+                    return false;
+                }
+            }
+
+            intersection = rect(x0, y0, x1 - x0, y1 - y0);
+            return true;
+        }
+
+        // Gets the area shared by two rects, or an empty rect if they don't overlap.
+        constexpr rect make_intersection(const rect& rectangle) const
+        {
+            rect result;
+            intersect(rectangle, result);
+            return result;
+        }
+
+        // Clips this rect to the bounds. Returns false, and becomes an empty rect, if nothing is left.
+        constexpr bool clip_to(const rect& bounds)
+        {
+            return intersect(bounds, *this);
+        }
+
+        // Gets what's left of this rect after cutting out another rect, as up to 4 non-overlapping pieces:
+        // a full width band below the cut (lesser y), a full width band above it (greater y), then the pieces to the left
+        // and right of the cut. Returns the number of pieces. Pieces share edges with the cut-out rect.
+        constexpr unsigned int subtract(const rect& rectangle, rect(&pieces)[4]) const
+        {
+            rect cut;
+            if (!intersect(rectangle, cut) || 0 == cut._size.width || 0 == cut._size.height)
+            {
+                pieces[0] = *this;
+                return 1u;
+            }
+
+            const auto x0 = _location.x;
+            const auto y0 = _location.y;
+            const auto x1 = _location.x + _size.width;
+            const auto y1 = _location.y + _size.height;
+            const auto cut_x1 = cut._location.x + cut._size.width;
+            const auto cut_y1 = cut._location.y + cut._size.height;
+
+            auto count = 0u;
+            if (y0 < cut._location.y)
+            {
+                pieces[count++] = rect(x0, y0, _size.width, cut._location.y - y0);
+            }
+            if (cut_y1 < y1)
+            {
+                pieces[count++] = rect(x0, cut_y1, _size.width, y1 - cut_y1);
+            }
+            if (x0 < cut._location.x)
+            {
+                pieces[count++] = rect(x0, cut._location.y, cut._location.x - x0, cut._size.height);
+            }
+            if (cut_x1 < x1)
+            {
+                pieces[count++] = rect(cut_x1, cut._location.y, x1 - cut_x1, cut._size.height);
+            }
+            return count;
+        }
+
         constexpr void swap(rect& rhs) noexcept
         {
             _location.swap(rhs._location);
@@ -327,6 +413,198 @@ namespace impl
         return result;
     }
 
+    // Integer-Exact Rect Math
+    //////////////////////////
+
+    // The far edges of integer rects, clamped to the scalar type's limits instead of wrapping around.
+    template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+    inline constexpr ScalarT saturating_right(const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& rectangle)
+    {
+        return saturating_add(rectangle.x(), rectangle.width());
+    }
+
+    template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+    inline constexpr ScalarT saturating_top(const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& rectangle)
+    {
+        if constexpr (std::is_same_v<YAxesPolicy, StandardYAxis>)
+        {
+            return saturating_add(rectangle.y(), rectangle.height());
+        }
+        else
+        {
+            return rectangle.y();
+        }
+    }
+
+    template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+    inline constexpr ScalarT saturating_bottom(const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& rectangle)
+    {
+        if constexpr (std::is_same_v<YAxesPolicy, StandardYAxis>)
+        {
+            return rectangle.y();
+        }
+        else
+        {
+            return saturating_add(rectangle.y(), rectangle.height());
+        }
+    }
+
+    // make_union() with the far edges, and the size, clamped to the scalar type's limits.
+    template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+    inline constexpr impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy> saturating_union(
+        const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& lhs,
+        const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& rhs
+        )
+    {
+        const auto x = min(lhs.x(), rhs.x());
+        const auto y = min(lhs.y(), rhs.y());
+        const auto x1 = max(saturating_add(lhs.x(), lhs.width()), saturating_add(rhs.x(), rhs.width()));
+        const auto y1 = max(saturating_add(lhs.y(), lhs.height()), saturating_add(rhs.y(), rhs.height()));
+        return impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>(x, y, saturating_sub(x1, x), saturating_sub(y1, y));
+    }
+
+    // make_union(); returns false, and leaves union_rect alone, if an edge or the size doesn't fit the scalar type.
+    template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+    inline constexpr bool checked_union(
+        const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& lhs,
+        const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& rhs,
+        impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& union_rect
+        )
+    {
+        ScalarT lhs_x1 = 0, lhs_y1 = 0, rhs_x1 = 0, rhs_y1 = 0, width = 0, height = 0;
+        const auto x = min(lhs.x(), rhs.x());
+        const auto y = min(lhs.y(), rhs.y());
+        const auto fits = checked_add(lhs.x(), lhs.width(), lhs_x1) & checked_add(lhs.y(), lhs.height(), lhs_y1) &
+            checked_add(rhs.x(), rhs.width(), rhs_x1) & checked_add(rhs.y(), rhs.height(), rhs_y1) &
+            checked_sub(max(lhs_x1, rhs_x1), x, width) & checked_sub(max(lhs_y1, rhs_y1), y, height);
+        if (fits)
+        {
+            union_rect = impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>(x, y, width, height);
+        }
+        return fits;
+    }
+
+    // intersect() with the far edges clamped to the scalar type's limits; so a rect reaching past the limits (like a
+    // "clip to everything" rect) still clips correctly.
+    template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+    inline constexpr bool saturating_intersect(
+        const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& lhs,
+        const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& rhs,
+        impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& intersection
+        )
+    {
+        const auto x0 = max(lhs.x(), rhs.x());
+        const auto y0 = max(lhs.y(), rhs.y());
+        const auto x1 = min(saturating_add(lhs.x(), lhs.width()), saturating_add(rhs.x(), rhs.width()));
+        const auto y1 = min(saturating_add(lhs.y(), lhs.height()), saturating_add(rhs.y(), rhs.height()));
+
+        const auto overlapping = std::is_same_v<BoundsCheckPolicy, ClosedIntervals> ? x0 <= x1 && y0 <= y1 : x0 < x1 && y0 < y1;
+        intersection = overlapping ? impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>(x0, y0, x1 - x0, y1 - y0) : impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>();
+        return overlapping;
+    }
+
+    // Clips count integer rects to the bounds, with saturated far edges. Rects left with nothing get a zero size, at the
+    // nearest spot inside the bounds. results may be rects.
+    // Returns the number of rects that overlap the bounds (touching counts for ClosedIntervals, as in intersect()).
+    // NOTE: The loop works on the rects as arrays of scalars, with no branches, so that it vectorizes.
+    template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+    inline size_t clip_rects(
+        const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>* const rects,
+        const size_t count,
+        const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& bounds,
+        impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>* const results
+        )
+    {
+        static_assert(sizeof(impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>) == sizeof(ScalarT) * 4, "rects must be x, y, width, height");
+        assert((nullptr != rects && nullptr != results) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("clip_rects", count);
+        const auto bounds_x0 = bounds.x();
+        const auto bounds_y0 = bounds.y();
+        const auto bounds_x1 = saturating_add(bounds.x(), bounds.width());
+        const auto bounds_y1 = saturating_add(bounds.y(), bounds.height());
+        const auto source = reinterpret_cast<const ScalarT*>(rects);
+        const auto destination = reinterpret_cast<ScalarT*>(results);
+
+        // The hit count is kept in the scalar type, which lets the loop vectorize; in blocks small enough not to overflow it.
+        using count_type = std::make_unsigned_t<ScalarT>;
+        constexpr auto block_size = size_t(1) << (sizeof(ScalarT) > 1 ? 15 : 7);
+        auto hits = size_t(0);
+        for (auto first = size_t(0); first < count; first += block_size)
+        {
+            const auto last = min(count, first + block_size);
+            count_type block_hits = 0;
+            for (auto i = first; i < last; i++)
+            {
+                const auto x = source[i * 4 + 0], y = source[i * 4 + 1];
+                const auto x0 = min(max(x, bounds_x0), bounds_x1);
+                const auto y0 = min(max(y, bounds_y0), bounds_y1);
+                const auto x1 = min(saturating_add(x, source[i * 4 + 2]), bounds_x1);
+                const auto y1 = min(saturating_add(y, source[i * 4 + 3]), bounds_y1);
+
+                bool overlapping;
+                if constexpr (std::is_same_v<BoundsCheckPolicy, ClosedIntervals>)
+                {
+                    overlapping = (x0 <= x1) & (y0 <= y1);
+                }
+                else
+                {
+                    overlapping = (x0 < x1) & (y0 < y1);
+                }
+                const auto empty = (x1 <= x0) | (y1 <= y0);
+                block_hits += overlapping ? count_type(1) : count_type(0);
+                destination[i * 4 + 0] = x0;
+                destination[i * 4 + 1] = y0;
+                destination[i * 4 + 2] = empty ? ScalarT(0) : static_cast<ScalarT>(x1 - x0);
+                destination[i * 4 + 3] = empty ? ScalarT(0) : static_cast<ScalarT>(y1 - y0);
+            }
+            hits += block_hits;
+        }
+        return hits;
+    }
+
+    // to_raster_rect() and from_raster_rect() that return false, and leave result alone, when the flipped rect doesn't
+    // fit the destination scalar type (like a negative y into an unsigned raster_rectui). Unlike those, they don't
+    // truncate; a floating-point rect with a fractional edge, NaN, or an out of range value is rejected.
+    template<typename dst_scalar_type, typename src_scalar_type>
+    inline constexpr bool checked_to_raster_rect(
+        const impl::rect<src_scalar_type>& rectangle,
+        const int_fast32_t client_height,
+        impl::rect<dst_scalar_type, InvertedYAxis, RightOpenIntervals>& result
+        )
+    {
+        int64_t y = 0, height = 0, top = 0, flipped_y = 0;
+        dst_scalar_type x = 0, dst_y = 0, dst_width = 0, dst_height = 0;
+        const auto fits = checked_cast(rectangle.y(), y) & checked_cast(rectangle.height(), height) &
+            checked_add(y, height, top) & checked_sub(static_cast<int64_t>(client_height), top, flipped_y) &
+            checked_cast(rectangle.x(), x) & checked_cast(flipped_y, dst_y) &
+            checked_cast(rectangle.width(), dst_width) & checked_cast(rectangle.height(), dst_height);
+        if (fits)
+        {
+            result = impl::rect<dst_scalar_type, InvertedYAxis, RightOpenIntervals>(x, dst_y, dst_width, dst_height);
+        }
+        return fits;
+    }
+
+    template<typename dst_scalar_type, typename src_scalar_type>
+    inline constexpr bool checked_from_raster_rect(
+        const impl::rect<src_scalar_type, InvertedYAxis, RightOpenIntervals>& rectangle,
+        const int_fast32_t client_height,
+        impl::rect<dst_scalar_type>& result
+        )
+    {
+        int64_t y = 0, height = 0, bottom = 0, flipped_y = 0;
+        dst_scalar_type x = 0, dst_y = 0, dst_width = 0, dst_height = 0;
+        const auto fits = checked_cast(rectangle.y(), y) & checked_cast(rectangle.height(), height) &
+            checked_add(y, height, bottom) & checked_sub(static_cast<int64_t>(client_height), bottom, flipped_y) &
+            checked_cast(rectangle.x(), x) & checked_cast(flipped_y, dst_y) &
+            checked_cast(rectangle.width(), dst_width) & checked_cast(rectangle.height(), dst_height);
+        if (fits)
+        {
+            result = impl::rect<dst_scalar_type>(x, dst_y, dst_width, dst_height);
+        }
+        return fits;
+    }
+
 #ifdef _WINDEF_
     using winRECT_scalar_t = decltype(RECT::left);
 #ifdef _TYPE_TRAITS_
@@ -0,0 +1,801 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGREGION_HPP
+#define CLGREGION_HPP
+
+#ifndef CLGRECTANGLE_HPP
+  #include "clg_rectangle.hpp"
+#endif
+
+namespace clg
+{
+    /*
+     *
+     * A set of pixels, or area, made from any number of rects; similar to X11 regions.
+     *
+     * The region is stored as y-sorted, non-overlapping horizontal bands. Each band holds x-sorted, non-overlapping,
+     * non-touching spans. Identical neighboring bands are coalesced, so two regions covering the same area always
+     * have the same representation.
+     *
+     * Unite, intersect, and subtract sweep both regions' bands in a single linear pass. Building a region from n
+     * rects unites them pairwise in log(n) rounds; O(n log n) for typical UI layouts.
+     *
+     * The bands store the rects' area, so the zero width or height pieces produced by touching ClosedIntervals rects
+     * are dropped. The BoundsCheckPolicy is applied by contains() and overlaps() at the region's edges. Since the
+     * location of a rect is its least y corner under either YAxesPolicy, the bands are stored in raw y coordinates.
+     *
+     */
+    template<
+        typename ScalarT,
+        typename YAxesPolicy        = StandardYAxis,
+        typename BoundsCheckPolicy  = ClosedIntervals
+        >
+    class region
+    {
+    public:
+        using scalar_type   = ScalarT;
+        using rect_type     = impl::rect<scalar_type, YAxesPolicy, BoundsCheckPolicy>;
+        using point_type    = typename rect_type::point_type;
+        using area_type     = std::conditional_t<std::is_integral_v<scalar_type>, long long, scalar_type>;
+
+        region() { }
+
+        explicit region(const rect_type& rectangle)
+        {
+            add_band(rectangle.y(), rectangle.y() + rectangle.height(), rectangle.x(), rectangle.x() + rectangle.width());
+        }
+
+        // Builds the union of many rects.
+        explicit region(const rect_type* const rectangles, const size_t count)
+        {
+            assert(nullptr != rectangles || 0 == count);
+            std::vector<region> level;
+            level.reserve(count);
+            for (auto i = size_t(0); i < count; i++)
+            {
+                level.emplace_back(rectangles[i]);
+            }
+
+            while (level.size() > 1)
+            {
+                auto k = size_t(0);
+                for (auto i = size_t(0); i + 1 < level.size(); i += 2)
+                {
+                    level[k++] = combine(level[i], level[i + 1], operation::unite);
+                }
+                if (level.size() & 1)
+                {
+                    level[k++] = std::move(level.back());
+                }
+                level.resize(k);
+            }
+
+            if (!level.empty())
+            {
+                swap(level.front());
+            }
+        }
+
+        bool operator ==(const region& rhs) const
+        {
+            if (_bands.size() != rhs._bands.size() || _spans.size() != rhs._spans.size())
+            {
+                return false;
+            }
+            for (auto i = size_t(0); i < _bands.size(); i++)
+            {
+                if (_bands[i].y0 != rhs._bands[i].y0 || _bands[i].y1 != rhs._bands[i].y1 || _bands[i].first != rhs._bands[i].first)
+                {
+                    return false;
+                }
+            }
+            for (auto i = size_t(0); i < _spans.size(); i++)
+            {
+                if (_spans[i].x0 != rhs._spans[i].x0 || _spans[i].x1 != rhs._spans[i].x1)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator !=(const region& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        bool empty() const
+        {
+            return _bands.empty();
+        }
+
+        void clear()
+        {
+            _bands.clear();
+            _spans.clear();
+        }
+
+        // Number of rects it takes to draw the region.
+        size_t rect_count() const
+        {
+            return _spans.size();
+        }
+
+        // Gets the smallest rect containing the whole region.
+        rect_type bounds() const
+        {
+            if (_bands.empty())
+            {
+                return rect_type();
+            }
+
+            auto x0 = _spans.front().x0;
+            auto x1 = _spans.front().x1;
+            for (const auto& s : _spans)
+            {
+                x0 = min(x0, s.x0);
+                x1 = max(x1, s.x1);
+            }
+            const auto y0 = _bands.front().y0;
+            const auto y1 = _bands.back().y1;
+            return rect_type(x0, y0, x1 - x0, y1 - y0);
+        }
+
+        area_type area() const
+        {
+            auto total = area_type(0);
+            for (const auto& b : _bands)
+            {
+                for (auto i = b.first; i < b.last; i++)
+                {
+                    total += static_cast<area_type>(_spans[i].x1 - _spans[i].x0) * static_cast<area_type>(b.y1 - b.y0);
+                }
+            }
+            return total;
+        }
+
+        bool contains(const point_type& point) const
+        {
+            // At most two bands can touch a row; one ending on it and the other starting on it.
+            const auto upper = std::upper_bound(_bands.begin(), _bands.end(), point.y, [](const scalar_type y, const band& b) { return y < b.y0; });
+            for (auto b = upper; b != _bands.begin() && std::distance(b, upper) < 2;)
+            {
+                --b;
+                if (!inside(point.y, b->y0, b->y1))
+                {
+                    continue;
+                }
+
+                const auto first = _spans.begin() + b->first;
+                const auto last = _spans.begin() + b->last;
+                const auto s = std::upper_bound(first, last, point.x, [](const scalar_type x, const span& sp) { return x < sp.x0; });
+                if (s != first && inside(point.x, (s - 1)->x0, (s - 1)->x1))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool overlaps(const rect_type& rectangle) const
+        {
+            const auto x0 = rectangle.x();
+            const auto y0 = rectangle.y();
+            const auto x1 = rectangle.x() + rectangle.width();
+            const auto y1 = rectangle.y() + rectangle.height();
+            for (const auto& b : _bands)
+            {
+                if (!ranges_overlap(b.y0, b.y1, y0, y1))
+                {
+                    continue;
+                }
+                for (auto i = b.first; i < b.last; i++)
+                {
+                    if (ranges_overlap(_spans[i].x0, _spans[i].x1, x0, x1))
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        region unite(const region& rhs) const
+        {
+            return combine(*this, rhs, operation::unite);
+        }
+
+        region intersect(const region& rhs) const
+        {
+            return combine(*this, rhs, operation::intersect);
+        }
+
+        region subtract(const region& rhs) const
+        {
+            return combine(*this, rhs, operation::subtract);
+        }
+
+        region unite(const rect_type& rhs) const
+        {
+            return combine(*this, region(rhs), operation::unite);
+        }
+
+        region intersect(const rect_type& rhs) const
+        {
+            return combine(*this, region(rhs), operation::intersect);
+        }
+
+        region subtract(const rect_type& rhs) const
+        {
+            return combine(*this, region(rhs), operation::subtract);
+        }
+
+        // Calls visit(const rect_type&) for each of the region's rects in y, then x, order.
+        template<typename visitor_type>
+        void for_each_rect(visitor_type visit) const
+        {
+            for (const auto& b : _bands)
+            {
+                for (auto i = b.first; i < b.last; i++)
+                {
+                    visit(rect_type(_spans[i].x0, b.y0, _spans[i].x1 - _spans[i].x0, b.y1 - b.y0));
+                }
+            }
+        }
+
+        // Appends the region's rects to the list.
+        void rects(std::vector<rect_type>& list) const
+        {
+            list.reserve(list.size() + _spans.size());
+            for_each_rect([&list](const rect_type& r) { list.push_back(r); });
+        }
+
+        void swap(region& rhs) noexcept
+        {
+            _bands.swap(rhs._bands);
+            _spans.swap(rhs._spans);
+        }
+
+    private:
+        struct span
+        {
+            scalar_type x0;
+            scalar_type x1;
+        };
+
+        struct band
+        {
+            scalar_type y0;
+            scalar_type y1;
+            uint32_t    first;  // index of the first span in the band
+            uint32_t    last;   // one past the last span in the band
+        };
+
+        enum class operation { unite, intersect, subtract };
+
+        static constexpr bool inside(const scalar_type value, const scalar_type low, const scalar_type high)
+        {
+            if constexpr (std::is_same_v<BoundsCheckPolicy, ClosedIntervals>)
+            {
+                return low <= value && value <= high; // NOTE: Inclusive coordinates.
+            }
+            else
+            {
+                return low <= value && value < high; // NOTE: Exclusive coordinates.
+            }
+        }
+
+        static constexpr bool ranges_overlap(const scalar_type low0, const scalar_type high0, const scalar_type low1, const scalar_type high1)
+        {
+            if constexpr (std::is_same_v<BoundsCheckPolicy, ClosedIntervals>)
+            {
+                return !(high0 < low1 || high1 < low0); // NOTE: Inclusive coordinates.
+            }
+            else
+            {
+                return !(high0 <= low1 || high1 <= low0); // NOTE: Exclusive coordinates.
+            }
+        }
+
+        void add_band(const scalar_type y0, const scalar_type y1, const scalar_type x0, const scalar_type x1)
+        {
+            if (y0 < y1 && x0 < x1)
+            {
+                const auto first = static_cast<uint32_t>(_spans.size());
+                _spans.push_back(span{ x0, x1 });
+                _bands.push_back(band{ y0, y1, first, first + 1u });
+            }
+        }
+
+        // Appends the spans of a band that were just pushed onto _spans, or coalesces them into the previous band.
+        void close_band(const scalar_type y0, const scalar_type y1, const uint32_t first)
+        {
+            const auto last = static_cast<uint32_t>(_spans.size());
+            if (first == last)
+            {
+                return;
+            }
+
+            if (!_bands.empty())
+            {
+                auto& previous = _bands.back();
+                if (previous.y1 == y0 && previous.last - previous.first == last - first)
+                {
+                    auto same = true;
+                    for (auto i = 0u; i < last - first && same; i++)
+                    {
+                        same = _spans[previous.first + i].x0 == _spans[first + i].x0 && _spans[previous.first + i].x1 == _spans[first + i].x1;
+                    }
+                    if (same)
+                    {
+                        previous.y1 = y1;
+                        _spans.resize(first);
+                        return;
+                    }
+                }
+            }
+            _bands.push_back(band{ y0, y1, first, last });
+        }
+
+        void push_span(const scalar_type x0, const scalar_type x1, const uint32_t band_first)
+        {
+            if (!(x0 < x1))
+            {
+                return;
+            }
+            if (_spans.size() > band_first && !(_spans.back().x1 < x0))
+            {
+                _spans.back().x1 = max(_spans.back().x1, x1);
+                return;
+            }
+            _spans.push_back(span{ x0, x1 });
+        }
+
+        // 1D combination of two sorted span lists, appended to this region's spans.
+        void combine_spans(const span* a, const span* const a_end, const span* b, const span* const b_end, const operation op)
+        {
+            const auto first = static_cast<uint32_t>(_spans.size());
+            switch (op)
+            {
+            case operation::unite:
+                while (a != a_end || b != b_end)
+                {
+                    const auto& next = (b == b_end || (a != a_end && a->x0 < b->x0)) ? *a++ : *b++;
+                    push_span(next.x0, next.x1, first);
+                }
+                break;
+
+            case operation::intersect:
+                while (a != a_end && b != b_end)
+                {
+                    push_span(max(a->x0, b->x0), min(a->x1, b->x1), first);
+                    if (a->x1 < b->x1)
+                    {
+                        a++;
+                    }
+                    else
+                    {
+                        b++;
+                    }
+                }
+                break;
+
+            case operation::subtract:
+                for (; a != a_end; a++)
+                {
+                    auto x0 = a->x0;
+                    while (b != b_end && !(a->x0 < b->x1))
+                    {
+                        b++;
+                    }
+                    for (auto cut = b; cut != b_end && cut->x0 < a->x1; cut++)
+                    {
+                        push_span(x0, min(cut->x0, a->x1), first);
+                        x0 = max(x0, cut->x1);
+                    }
+                    push_span(x0, a->x1, first);
+                }
+                break;
+            }
+        }
+
+        static region combine(const region& lhs, const region& rhs, const operation op)
+        {
+            region result;
+            result._bands.reserve(lhs._bands.size() + rhs._bands.size());
+            result._spans.reserve(lhs._spans.size() + rhs._spans.size());
+
+            auto a = lhs._bands.begin();
+            auto b = rhs._bands.begin();
+            const auto a_end = lhs._bands.end();
+            const auto b_end = rhs._bands.end();
+            if (a == a_end && b == b_end)
+            {
+                return result;
+            }
+
+            auto y = (b == b_end || (a != a_end && a->y0 < b->y0)) ? a->y0 : b->y0;
+            while (a != a_end || b != b_end)
+            {
+                const auto a_active = a != a_end && !(y < a->y0);
+                const auto b_active = b != b_end && !(y < b->y0);
+                if (!a_active && !b_active)
+                {
+                    y = (b == b_end || (a != a_end && a->y0 < b->y0)) ? a->y0 : b->y0;
+                    continue;
+                }
+
+                // The band ends where either region's active band ends, or the other region's next band starts.
+                auto y_next = a_active ? a->y1 : b->y1;
+                if (a != a_end)
+                {
+                    y_next = min(y_next, a_active ? a->y1 : a->y0);
+                }
+                if (b != b_end)
+                {
+                    y_next = min(y_next, b_active ? b->y1 : b->y0);
+                }
+
+                const auto keep = (operation::unite == op) || (operation::intersect == op ? a_active && b_active : a_active);
+                if (keep)
+                {
+                    const auto first = static_cast<uint32_t>(result._spans.size());
+                    const auto* const a_spans = lhs._spans.data();
+                    const auto* const b_spans = rhs._spans.data();
+                    result.combine_spans(
+                        a_active ? a_spans + a->first : nullptr, a_active ? a_spans + a->last : nullptr,
+                        b_active ? b_spans + b->first : nullptr, b_active ? b_spans + b->last : nullptr,
+                        op);
+                    result.close_band(y, y_next, first);
+                }
+
+                y = y_next;
+                if (a != a_end && !(y < a->y1))
+                {
+                    a++;
+                }
+                if (b != b_end && !(y < b->y1))
+                {
+                    b++;
+                }
+            }
+
+            return result;
+        }
+
+        std::vector<band>   _bands;
+        std::vector<span>   _spans;
+    };
+
+    /*
+     *
+     * Accumulates invalidated raster rects over a frame, coalescing them into a short list of repaint rects.
+     *
+     * Two rects are merged when the pixels wasted by drawing their union, instead of drawing them separately, costs
+     * less than a draw call. Adjacent rects that line up, and rects that overlap, merge for free. When the list is
+     * at its cap an incoming rect is merged with whichever rect wastes the fewest pixels, so the count never exceeds
+     * max_rects; then any rects the union spread over are merged into it too, so no pixel is drawn twice because of it.
+     *
+     * Candidates for merging are looked up in a uniform grid of cells over the surface, so adding a rect only looks
+     * at the rects around it rather than at every rect added so far.
+     *
+     */
+    template<typename ScalarT = int_fast32_t>
+    class dirty_region
+    {
+    public:
+        using scalar_type   = ScalarT;
+        using rect_type     = impl::rect<scalar_type, InvertedYAxis, RightOpenIntervals>;
+        using area_type     = std::conditional_t<std::is_integral_v<scalar_type>, long long, scalar_type>;
+
+        // bounds        - the surface being tracked; invalidations are clipped to it
+        // max_rects     - the most rects (draw calls) the region will ever report
+        // draw_call_cost - how many wasted pixels a draw call is worth
+        // cell_size     - edge length of the grid cells used to find merge candidates
+        explicit dirty_region(
+            const rect_type& bounds,
+            const size_t max_rects = 32,
+            const area_type draw_call_cost = area_type(64 * 64),
+            const scalar_type cell_size = scalar_type(64)
+            )
+            : _bounds(bounds)
+            , _max_rects(max(max_rects, size_t(1)))
+            , _draw_call_cost(draw_call_cost)
+            , _cell_size(max(cell_size, scalar_type(1)))
+        {
+            _columns = static_cast<size_t>((bounds.width() + _cell_size - scalar_type(1)) / _cell_size);
+            _rows = static_cast<size_t>((bounds.height() + _cell_size - scalar_type(1)) / _cell_size);
+            _cells.resize(max(_columns * _rows, size_t(1)));
+        }
+
+        constexpr const rect_type& bounds() const
+        {
+            return _bounds;
+        }
+
+        constexpr bool empty() const
+        {
+            return 0 == _live_count;
+        }
+
+        // Number of rects currently in the region.
+        constexpr size_t count() const
+        {
+            return _live_count;
+        }
+
+        // Forgets all invalidations, e.g. after the frame has been repainted. Keeps its memory for the next frame.
+        void clear()
+        {
+            for (auto& cell : _cells)
+            {
+                cell.clear();
+            }
+            _rects.clear();
+            _live.clear();
+            _live_slots.clear();
+            _live_indices.clear();
+            _stamps.clear();
+            _compact.clear();
+            _live_count = 0;
+            _stamp = 0;
+            _dirty = false;
+        }
+
+        // Marks everything as needing a repaint.
+        void invalidate_all()
+        {
+            clear();
+            add(_bounds);
+        }
+
+        void add(const rect_type& rectangle)
+        {
+            auto merged = rectangle;
+            if (!merged.clip_to(_bounds))
+            {
+                return;
+            }
+
+            // Nothing to do when a rect already covers it; which is common once forced merges have made big rects.
+            auto covered = false;
+            for_each_candidate(merged, next_stamp(), [&](const uint32_t index)
+            {
+                covered = covered || area(merged.make_intersection(_rects[index])) == area(merged);
+            });
+            if (covered)
+            {
+                return;
+            }
+
+            absorb(merged, [this](const rect_type& lhs, const rect_type& rhs)
+            {
+                return waste(lhs, rhs) <= _draw_call_cost;
+            });
+
+            if (_live_count >= _max_rects)
+            {
+                while (_live_count >= _max_rects)
+                {
+                    merged = merged.make_union(_rects[take_cheapest_partner(merged)]);
+                }
+
+                // A forced union can spread over other rects; take them in too, so nothing is drawn twice.
+                absorb(merged, [](const rect_type& lhs, const rect_type& rhs)
+                {
+                    return lhs.overlaps(rhs);
+                });
+            }
+
+            insert(merged);
+        }
+
+        void add(const rect_type* const rectangles, const size_t count)
+        {
+            assert(nullptr != rectangles || 0 == count);
+            for (auto i = size_t(0); i < count; i++)
+            {
+                add(rectangles[i]);
+            }
+        }
+
+        // Gets the compact list of repaint rects. None of them overlap their neighbors by more than the merge
+        // heuristic allowed, and there are never more than max_rects of them.
+        const std::vector<rect_type>& rects() const
+        {
+            if (_dirty)
+            {
+                _compact.clear();
+                for (auto i = size_t(0); i < _rects.size(); i++)
+                {
+                    if (_live[i])
+                    {
+                        _compact.push_back(_rects[i]);
+                    }
+                }
+                _dirty = false;
+            }
+            return _compact;
+        }
+
+        // Total area of the repaint rects; the number of pixels that will be redrawn.
+        area_type area() const
+        {
+            auto total = area_type(0);
+            for (const auto& r : rects())
+            {
+                total += area(r);
+            }
+            return total;
+        }
+
+    private:
+        static constexpr area_type area(const rect_type& r)
+        {
+            return static_cast<area_type>(r.width()) * static_cast<area_type>(r.height());
+        }
+
+        // Pixels drawn by the union that neither rect covers; negative when the rects overlap.
+        static constexpr area_type waste(const rect_type& lhs, const rect_type& rhs)
+        {
+            return area(lhs.make_union(rhs)) - area(lhs) - area(rhs) + area(lhs.make_intersection(rhs));
+        }
+
+        // Keeps absorbing the neighbors that should_merge picks until the union stops growing.
+        template<typename predicate_type>
+        void absorb(rect_type& merged, predicate_type should_merge)
+        {
+            for (auto grew = true; grew;)
+            {
+                grew = false;
+                const auto stamp = next_stamp();
+                for_each_candidate(merged, stamp, [&](const uint32_t index)
+                {
+                    if (should_merge(merged, _rects[index]))
+                    {
+                        merged = merged.make_union(_rects[index]);
+                        remove(index);
+                        grew = true;
+                    }
+                });
+            }
+        }
+
+        uint32_t next_stamp()
+        {
+            if (++_stamp == 0)
+            {
+                std::fill(_stamps.begin(), _stamps.end(), 0u);
+                _stamp = 1;
+            }
+            return _stamp;
+        }
+
+        // Visits each live rect registered in a cell touched by r, grown by a pixel so edge-adjacent rects are found.
+        template<typename visitor_type>
+        void for_each_candidate(const rect_type& r, const uint32_t stamp, visitor_type visit)
+        {
+            size_t first_column, first_row, last_column, last_row;
+            cell_range(r, scalar_type(1), first_column, first_row, last_column, last_row);
+            for (auto row = first_row; row <= last_row; row++)
+            {
+                for (auto column = first_column; column <= last_column; column++)
+                {
+                    auto& cell = _cells[row * _columns + column];
+                    for (auto k = size_t(0); k < cell.size();)
+                    {
+                        const auto index = cell[k];
+                        if (!_live[index])
+                        {
+                            // Lazily drop merged rects from the cell.
+                            cell[k] = cell.back();
+                            cell.pop_back();
+                            continue;
+                        }
+                        k++;
+                        if (_stamps[index] != stamp)
+                        {
+                            _stamps[index] = stamp;
+                            visit(index);
+                        }
+                    }
+                }
+            }
+        }
+
+        void cell_range(const rect_type& r, const scalar_type grow, size_t& first_column, size_t& first_row, size_t& last_column, size_t& last_row) const
+        {
+            const auto to_cell = [this](const scalar_type offset, const size_t count)
+            {
+                if (offset <= scalar_type(0))
+                {
+                    return size_t(0);
+                }
+                return min(static_cast<size_t>(offset / _cell_size), count - 1);
+            };
+
+            const auto columns = max(_columns, size_t(1));
+            const auto rows = max(_rows, size_t(1));
+            first_column = to_cell(r.left() - _bounds.left() - min(grow, r.left() - _bounds.left()), columns);
+            first_row = to_cell(r.top() - _bounds.top() - min(grow, r.top() - _bounds.top()), rows);
+            last_column = to_cell(r.right() - _bounds.left() - scalar_type(1) + grow, columns);
+            last_row = to_cell(r.bottom() - _bounds.top() - scalar_type(1) + grow, rows);
+        }
+
+        void insert(const rect_type& r)
+        {
+            const auto index = static_cast<uint32_t>(_rects.size());
+            _rects.push_back(r);
+            _live.push_back(true);
+            _live_slots.push_back(static_cast<uint32_t>(_live_indices.size()));
+            _live_indices.push_back(index);
+            _stamps.push_back(0u);
+            _live_count++;
+            _dirty = true;
+
+            size_t first_column, first_row, last_column, last_row;
+            cell_range(r, scalar_type(0), first_column, first_row, last_column, last_row);
+            for (auto row = first_row; row <= last_row; row++)
+            {
+                for (auto column = first_column; column <= last_column; column++)
+                {
+                    _cells[row * _columns + column].push_back(index);
+                }
+            }
+        }
+
+        void remove(const uint32_t index)
+        {
+            // Swap the last live index into this one's slot, so _live_indices stays compact.
+            const auto slot = _live_slots[index];
+            _live_indices[slot] = _live_indices.back();
+            _live_slots[_live_indices[slot]] = slot;
+            _live_indices.pop_back();
+            _live[index] = false;
+            _live_count--;
+            _dirty = true;
+        }
+
+        // Only called when the region is full, so this scans max_rects live rects.
+        uint32_t take_cheapest_partner(const rect_type& r)
+        {
+            auto best = ~uint32_t(0);
+            auto best_waste = area_type(0);
+            for (const auto index : _live_indices)
+            {
+                const auto w = waste(r, _rects[index]);
+                if (~uint32_t(0) == best || w < best_waste)
+                {
+                    best = index;
+                    best_waste = w;
+                }
+            }
+            assert(~uint32_t(0) != best);
+            remove(best);
+            return best;
+        }
+
+        rect_type                               _bounds;
+        size_t                                  _max_rects;
+        area_type                               _draw_call_cost;
+        scalar_type                             _cell_size;
+        size_t                                  _columns = 0;
+        size_t                                  _rows = 0;
+        std::vector<std::vector<uint32_t>>      _cells;
+        std::vector<rect_type>                  _rects;
+        std::vector<bool>                       _live;
+        std::vector<uint32_t>                   _live_slots;        // each rect's position in _live_indices, while it's live
+        std::vector<uint32_t>                   _live_indices;      // the live rects, in no particular order
+        std::vector<uint32_t>                   _stamps;
+        size_t                                  _live_count = 0;
+        uint32_t                                _stamp = 0;
+        mutable std::vector<rect_type>          _compact;
+        mutable bool                            _dirty = false;
+    };
+} // namespace clg
+
+#endif
@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGSKINNING_HPP
+#define CLGSKINNING_HPP
+
+#ifndef CLGDUALQUATERNION_HPP
+  #include "clg_dual_quaternion.hpp"
+#endif
+
+/*
+ *
+ * Skeletal mesh skinning kernels over structure-of-arrays vertex streams, with four bone weights per vertex.
+ *
+ *  linear_blend_skin()     - blends the bone matrices; cheap, but the mesh collapses around twisting joints
+ *  dual_quat_skin()        - blends rigid bone transforms as dual quaternions; keeps the volume around joints
+ *
+ * The kernels work on the vertex range [first, last), and only write those vertices of the output streams; so a
+ * mesh can be skinned in parallel by giving each thread its own range. The weights of each vertex should add up to 1.
+ *
+ * Example:
+ *  clg::to_dual_quats(bone_matrices, bone_count, bones);  // once per frame
+ *  clg::dual_quat_skin(bones, streams, positions, normals, first, last); // per thread
+ *
+ */
+
+namespace clg
+{
+    using skin_joints = impl::vec<uint16_t, 4>;
+
+    // Input vertex streams; each is indexed by vertex.
+    struct skin_streams
+    {
+        const vec3*         positions;
+        const vec3*         normals;    // optional; nullptr skips the normals
+        const vec4*         weights;    // of each joint
+        const skin_joints*  joints;     // bone indices
+    };
+
+    // Converts rigid bone matrices, like translation_matrix(t) * rotation, to unit dual quaternions.
+    inline void to_dual_quats(const mat4* const matrices, const size_t count, dual_quat* const results)
+    {
+        assert((nullptr != matrices && nullptr != results) || 0 == count);
+        CLG_INSTRUMENT_SCOPE("to_dual_quats", count);
+        for (auto i = size_t(0); i < count; i++)
+        {
+            results[i] = dual_quat(matrices[i]);
+        }
+    }
+
+    // Skins [first, last) by the weighted sum of the bone matrices. The normals are transformed by the same blended
+    // matrix, and renormalized.
+    inline void linear_blend_skin(
+        const mat4* const bones,
+        const skin_streams& vertices,
+        vec3* const positions,
+        vec3* const normals,
+        const size_t first,
+        const size_t last
+        )
+    {
+        assert(nullptr != bones && nullptr != vertices.positions && nullptr != vertices.weights && nullptr != vertices.joints);
+        assert(nullptr != positions && first <= last);
+        CLG_INSTRUMENT_SCOPE("linear_blend_skin", last - first);
+        const auto skin_normals = nullptr != vertices.normals && nullptr != normals;
+
+        for (auto v = first; v < last; v++)
+        {
+            // Only the upper 3x4 of the matrices matter; column-major.
+            float blended[12] = {};
+            const auto& weights = vertices.weights[v];
+            const auto& joints = vertices.joints[v];
+            for (auto i = 0u; i < 4; i++)
+            {
+                const auto weight = weights[i];
+                const auto& bone = bones[joints[i]].data();
+                for (auto column = 0u; column < 4; column++)
+                {
+                    blended[column * 3 + 0] += bone[column * 4 + 0] * weight;
+                    blended[column * 3 + 1] += bone[column * 4 + 1] * weight;
+                    blended[column * 3 + 2] += bone[column * 4 + 2] * weight;
+                }
+            }
+
+            const auto& p = vertices.positions[v];
+            positions[v] = vec3(
+                blended[0] * p.x + blended[3] * p.y + blended[6] * p.z + blended[9],
+                blended[1] * p.x + blended[4] * p.y + blended[7] * p.z + blended[10],
+                blended[2] * p.x + blended[5] * p.y + blended[8] * p.z + blended[11]);
+
+            if (skin_normals)
+            {
+                const auto& n = vertices.normals[v];
+                normals[v] = vec3(
+                    blended[0] * n.x + blended[3] * n.y + blended[6] * n.z,
+                    blended[1] * n.x + blended[4] * n.y + blended[7] * n.z,
+                    blended[2] * n.x + blended[5] * n.y + blended[8] * n.z).unit();
+            }
+        }
+    }
+
+    // Skins [first, last) by the normalized, weighted, sum of the bones' dual quaternions. Bones on the far side of the
+    // hypersphere from the first bone are negated, so the blend takes the short way around.
+    inline void dual_quat_skin(
+        const dual_quat* const bones,
+        const skin_streams& vertices,
+        vec3* const positions,
+        vec3* const normals,
+        const size_t first,
+        const size_t last
+        )
+    {
+        assert(nullptr != bones && nullptr != vertices.positions && nullptr != vertices.weights && nullptr != vertices.joints);
+        assert(nullptr != positions && first <= last);
+        CLG_INSTRUMENT_SCOPE("dual_quat_skin", last - first);
+        const auto skin_normals = nullptr != vertices.normals && nullptr != normals;
+
+        for (auto v = first; v < last; v++)
+        {
+            const auto& weights = vertices.weights[v];
+            const auto& joints = vertices.joints[v];
+            const auto& pivot = bones[joints[0]].real;
+
+            vec4 real(0.0f, 0.0f, 0.0f, 0.0f);
+            vec4 dual(0.0f, 0.0f, 0.0f, 0.0f);
+            for (auto i = 0u; i < 4; i++)
+            {
+                const auto& bone = bones[joints[i]];
+                const auto weight = pivot.dot(bone.real) < 0.0f ? -weights[i] : weights[i];
+                real += bone.real * weight;
+                dual += bone.dual * weight;
+            }
+
+            // Normalize, then transform: p' = rotate(real, p) + 2 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz))
+            const auto inverse_length = 1.0f / real.length();
+            real *= inverse_length;
+            dual *= inverse_length;
+            const vec3 axis(real.x, real.y, real.z);
+            const vec3 dual_axis(dual.x, dual.y, dual.z);
+            const auto translation = (dual_axis * real.w - axis * dual.w + axis.cross(dual_axis)) * 2.0f;
+
+            const auto& p = vertices.positions[v];
+            positions[v] = p + axis.cross(axis.cross(p) + p * real.w) * 2.0f + translation;
+
+            if (skin_normals)
+            {
+                const auto& n = vertices.normals[v];
+                normals[v] = n + axis.cross(axis.cross(n) + n * real.w) * 2.0f;
+            }
+        }
+    }
+} // namespace clg
+
+#endif
@@ -0,0 +1,360 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGTILES_HPP
+#define CLGTILES_HPP
+
+#ifndef CLGRECTANGLE_HPP
+  #include "clg_rectangle.hpp"
+#endif
+
+/*
+ *
+ * A grid of fixed size tiles over a surface, starting at ( 0, 0 ); for tiled renderers.
+ *
+ * covered() gets the range of tiles a rect touches, clipped to the grid, and iterates their ( column, row )
+ * coordinates in row order. Integer and floating-point rects both work; a floating-point rect covers every tile that
+ * any part of it lands in. Power-of-two tile sizes use shifts instead of divides.
+ *
+ * tile_bins sorts rects into per-tile lists with a counting sort (count, prefix sum, scatter), so binning N rects is
+ * O(N + tiles + the lists' total length) instead of testing every rect against every tile. Each list keeps the rects
+ * in their original order, so draw order is kept.
+ *
+ * Example:
+ *  const clg::tile_grid grid(1920, 1080, 64, 64);
+ *  for (const auto& tile : grid.covered(dirty_rect))
+ *  {
+ *      repaint(grid.tile_rect(tile.x, tile.y));
+ *  }
+ *  clg::tile_bins bins;
+ *  bins.build(grid, draw_rects, draw_count);                           // then, per tile: bins.begin(t)...bins.end(t)
+ *
+ */
+
+namespace clg
+{
+    // The tiles a rect covers; columns [first_column, end_column) of rows [first_row, end_row).
+    class tile_span
+    {
+    public:
+        using coordinate_type = impl::point<uint32_t>;
+
+        class iterator
+        {
+        public:
+            constexpr iterator(const uint32_t column, const uint32_t row, const uint32_t first_column, const uint32_t end_column)
+                : _tile(column, row)
+                , _first_column(first_column)
+                , _end_column(end_column) { }
+
+            constexpr const coordinate_type& operator *() const
+            {
+                return _tile;
+            }
+
+            constexpr iterator& operator ++()
+            {
+                if (++_tile.x == _end_column)
+                {
+                    _tile.x = _first_column;
+                    _tile.y++;
+                }
+                return *this;
+            }
+
+            constexpr bool operator ==(const iterator& rhs) const
+            {
+                return _tile == rhs._tile;
+            }
+
+            constexpr bool operator !=(const iterator& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+        private:
+            coordinate_type _tile;
+            uint32_t        _first_column;
+            uint32_t        _end_column;
+        };
+
+        constexpr tile_span() { }
+
+        constexpr tile_span(const uint32_t first_column, const uint32_t first_row, const uint32_t end_column, const uint32_t end_row)
+            : _first_column(first_column)
+            , _first_row(first_row)
+            , _end_column(end_column)
+            , _end_row(end_row) { }
+
+        constexpr uint32_t first_column() const
+        {
+            return _first_column;
+        }
+
+        constexpr uint32_t first_row() const
+        {
+            return _first_row;
+        }
+
+        constexpr uint32_t end_column() const
+        {
+            return _end_column;
+        }
+
+        constexpr uint32_t end_row() const
+        {
+            return _end_row;
+        }
+
+        constexpr bool empty() const
+        {
+            return _first_column == _end_column || _first_row == _end_row;
+        }
+
+        constexpr size_t size() const
+        {
+            return static_cast<size_t>(_end_column - _first_column) * (_end_row - _first_row);
+        }
+
+        constexpr iterator begin() const
+        {
+            return empty() ? end() : iterator(_first_column, _first_row, _first_column, _end_column);
+        }
+
+        constexpr iterator end() const
+        {
+            return iterator(_first_column, empty() ? _first_row : _end_row, _first_column, _end_column);
+        }
+
+    private:
+        uint32_t _first_column = 0;
+        uint32_t _first_row = 0;
+        uint32_t _end_column = 0;
+        uint32_t _end_row = 0;
+    };
+
+    class tile_grid
+    {
+    public:
+        // Enough tiles to cover the surface; the last row and column may hang over its edges.
+        tile_grid(const uint32_t surface_width, const uint32_t surface_height, const uint32_t tile_width, const uint32_t tile_height)
+            : _columns(tiles_along(surface_width, tile_width))
+            , _rows(tiles_along(surface_height, tile_height))
+            , _tile_width(tile_width)
+            , _tile_height(tile_height)
+            , _column_shift(tile_shift(tile_width))
+            , _row_shift(tile_shift(tile_height)) { }
+
+        uint32_t columns() const
+        {
+            return _columns;
+        }
+
+        uint32_t rows() const
+        {
+            return _rows;
+        }
+
+        size_t tile_count() const
+        {
+            return static_cast<size_t>(_columns) * _rows;
+        }
+
+        // row order
+        size_t tile_index(const uint32_t column, const uint32_t row) const
+        {
+            assert(column < _columns && row < _rows);
+            return static_cast<size_t>(row) * _columns + column;
+        }
+
+        raster_rectui tile_rect(const uint32_t column, const uint32_t row) const
+        {
+            return raster_rectui(column * _tile_width, row * _tile_height, _tile_width, _tile_height);
+        }
+
+        // Gets the tiles the rect covers, clipped to the grid.
+        template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+        tile_span covered(const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>& rectangle) const
+        {
+            // Either y-axis policy keeps the smallest coordinates in location().
+            uint32_t first_column, last_column, first_row, last_row;
+            if (!covered_axis<BoundsCheckPolicy>(rectangle.x(), rectangle.width(), _columns, _tile_width, _column_shift, first_column, last_column) ||
+                !covered_axis<BoundsCheckPolicy>(rectangle.y(), rectangle.height(), _rows, _tile_height, _row_shift, first_row, last_row))
+            {
+                return tile_span();
+            }
+            return tile_span(first_column, first_row, last_column + 1, last_row + 1);
+        }
+
+    private:
+        // Checks the tile size before dividing by it, since the members are initialized before the constructor's body.
+        static uint32_t tiles_along(const uint32_t surface_size, const uint32_t tile_size)
+        {
+            assert(tile_size > 0);
+            return surface_size / tile_size + (0 != surface_size % tile_size ? 1 : 0);
+        }
+
+        // The shift that divides by the tile size, or -1 if it isn't a power of two.
+        static int tile_shift(const uint32_t tile_size)
+        {
+            return round_up_to_nearest_power_of_two(tile_size) == tile_size ? static_cast<int>(highest_set_bit_index(tile_size)) : -1;
+        }
+
+        static int64_t divide(const int64_t coordinate, const uint32_t tile_size, const int shift)
+        {
+            return shift >= 0 ? coordinate >> shift : coordinate / tile_size;
+        }
+
+        // Gets the first and last tiles one axis of a rect covers; or false for none.
+        template<typename BoundsCheckPolicy, typename ScalarT>
+        static bool covered_axis(
+            const ScalarT low,
+            const ScalarT length,
+            const uint32_t tiles,
+            const uint32_t tile_size,
+            const int shift,
+            uint32_t& first,
+            uint32_t& last
+            )
+        {
+            constexpr auto closed = std::is_same_v<BoundsCheckPolicy, ClosedIntervals>;
+            constexpr auto int64_max = std::numeric_limits<int64_t>::max();
+
+            const auto extent = static_cast<int64_t>(tiles) * tile_size;
+            const auto outside = [extent](const auto low_edge, const auto high_edge)
+            {
+                return closed ?
+                    (high_edge < low_edge || high_edge < 0 || low_edge > extent) :
+                    (high_edge <= low_edge || high_edge <= 0 || low_edge >= extent);
+            };
+
+            // Round floating-point edges out to whole pixels, after the outside test; then the integer rules below
+            // cover every tile they touch.
+            int64_t low_edge, high_edge;
+            if constexpr (std::is_floating_point_v<ScalarT>)
+            {
+                const auto limit = static_cast<double>(int64_max / 2);
+                const auto low_limited = std::max(-limit, std::min(static_cast<double>(low), limit));
+                const auto high_limited = std::max(-limit, std::min(static_cast<double>(low) + static_cast<double>(length), limit));
+                if (outside(low_limited, high_limited))
+                {
+                    return false;
+                }
+                low_edge = static_cast<int64_t>(std::floor(low_limited));
+                high_edge = static_cast<int64_t>(closed ? std::floor(high_limited) : std::ceil(high_limited));
+            }
+            else
+            {
+                if constexpr (sizeof(ScalarT) < sizeof(int64_t))
+                {
+                    low_edge = static_cast<int64_t>(low);
+                    high_edge = low_edge + static_cast<int64_t>(length);
+                }
+                else
+                {
+                    const auto high = saturating_add(low, length);
+                    low_edge = std::is_unsigned_v<ScalarT> && static_cast<uint64_t>(low) > static_cast<uint64_t>(int64_max) ? int64_max : static_cast<int64_t>(low);
+                    high_edge = std::is_unsigned_v<ScalarT> && static_cast<uint64_t>(high) > static_cast<uint64_t>(int64_max) ? int64_max : static_cast<int64_t>(high);
+                }
+                if (outside(low_edge, high_edge))
+                {
+                    return false;
+                }
+            }
+            if (0 == tiles)
+            {
+                return false;
+            }
+
+            const auto last_tile = static_cast<int64_t>(tiles) - 1;
+            first = static_cast<uint32_t>(std::min(divide(std::max(low_edge, int64_t(0)), tile_size, shift), last_tile));
+            last = static_cast<uint32_t>(std::min(divide(std::min(high_edge, extent) - (closed ? 0 : 1), tile_size, shift), last_tile));
+            return true;
+        }
+
+        uint32_t    _columns;
+        uint32_t    _rows;
+        uint32_t    _tile_width;
+        uint32_t    _tile_height;
+        int         _column_shift;
+        int         _row_shift;
+    };
+
+    // Lists of the rects covering each tile of a grid; built once a frame, reusing its memory.
+    class tile_bins
+    {
+    public:
+        template<typename ScalarT, typename YAxesPolicy, typename BoundsCheckPolicy>
+        void build(const tile_grid& grid, const impl::rect<ScalarT, YAxesPolicy, BoundsCheckPolicy>* const rects, const size_t count)
+        {
+            assert(nullptr != rects || 0 == count);
+            CLG_INSTRUMENT_SCOPE("tile_bins::build", count);
+
+            // Counting sort of the (rect, tile) pairs by tile.
+            _offsets.assign(grid.tile_count() + 1, 0u);
+            _spans.resize(count);
+            for (auto i = size_t(0); i < count; i++)
+            {
+                _spans[i] = grid.covered(rects[i]);
+                for (auto row = _spans[i].first_row(); row < _spans[i].end_row(); row++)
+                {
+                    for (auto column = _spans[i].first_column(); column < _spans[i].end_column(); column++)
+                    {
+                        _offsets[grid.tile_index(column, row) + 1]++;
+                    }
+                }
+            }
+            for (auto t = size_t(0); t < grid.tile_count(); t++)
+            {
+                _offsets[t + 1] += _offsets[t];
+            }
+
+            _rects.resize(_offsets.back());
+            for (auto i = size_t(0); i < count; i++)
+            {
+                for (auto row = _spans[i].first_row(); row < _spans[i].end_row(); row++)
+                {
+                    for (auto column = _spans[i].first_column(); column < _spans[i].end_column(); column++)
+                    {
+                        _rects[_offsets[grid.tile_index(column, row)]++] = static_cast<uint32_t>(i);
+                    }
+                }
+            }
+
+            // Each offset now points at the next tile's start; shift them back.
+            for (auto t = grid.tile_count(); t > 0; t--)
+            {
+                _offsets[t] = _offsets[t - 1];
+            }
+            _offsets[0] = 0u;
+        }
+
+        size_t tile_count() const
+        {
+            return _offsets.empty() ? 0 : _offsets.size() - 1;
+        }
+
+        // the indexes of the rects covering a tile; from tile_grid::tile_index()
+        const uint32_t* begin(const size_t tile) const
+        {
+            assert(tile < tile_count());
+            return _rects.data() + _offsets[tile];
+        }
+
+        const uint32_t* end(const size_t tile) const
+        {
+            assert(tile < tile_count());
+            return _rects.data() + _offsets[tile + 1];
+        }
+
+    private:
+        std::vector<uint32_t>   _offsets;
+        std::vector<uint32_t>   _rects;
+        std::vector<tile_span>  _spans;     // each rect's tiles; kept between the counting and scattering passes
+    };
+} // namespace clg
+
+#endif
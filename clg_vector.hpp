@@ -137,6 +137,7 @@ namespace clg { namespace impl
         // gets normalized (unit vector) copy of the vector
         constexpr vec_type unit() const
         {
+            CLG_INSTRUMENT_COUNT(vector_normalize);
             vec_type result(static_cast<ref_const_type>(*this)._scalars);
             clg::vec_util::normalize(result._scalars);
             return result;
@@ -145,7 +146,8 @@ namespace clg { namespace impl
         // normalizes the current vector (converts to a unit vector)
         // returns the original magnitude (length)
         constexpr scalar_type normalize()
-        {   
+        {
+            CLG_INSTRUMENT_COUNT(vector_normalize);
             return clg::vec_util::normalize(static_cast<ref_type>(*this)._scalars);
         }
 
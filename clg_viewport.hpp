@@ -0,0 +1,211 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef CLGVIEWPORT_HPP
+#define CLGVIEWPORT_HPP
+
+#ifndef CLGRECTANGLE_HPP
+  #include "clg_rectangle.hpp"
+#endif
+#ifndef CLGMATRIX_HPP
+  #include "clg_matrix.hpp"
+#endif
+
+/*
+ *
+ * Projects world positions straight to raster pixel coordinates; ( 0, 0 ) at the top left, Y down, like raster_rect.
+ *
+ * The viewport mapping (and its Y flip) is folded into the view-projection matrix once, so each point costs 16
+ * multiply-adds and a divide. The batch versions also flag which points are visible (in front of the camera, between
+ * the near and far planes, and on a pixel of the viewport) and get the bounding rect of the visible ones, all in the
+ * same pass, without branches.
+ *
+ * Example:
+ *  const clg::screen_projection to_screen(projection * camera, clg::raster_rect(0, 0, 1920, 1080));
+ *  clg::raster_rect label_bounds;
+ *  const auto shown = to_screen.project(marker_positions, marker_count, marker_pixels, marker_visible, label_bounds);
+ *
+ */
+
+namespace clg
+{
+    class screen_projection
+    {
+    public:
+        using mask_type = uint64_t;
+        static constexpr size_t mask_bits = 64;
+
+        screen_projection(
+            const mat4& view_projection,
+            const raster_rect& viewport,
+            const clip_depth_range range = clip_depth_range::negative_one_to_one
+            )
+            : _left(static_cast<float>(viewport.x()))
+            , _top(static_cast<float>(viewport.y()))
+            , _right(static_cast<float>(viewport.x() + viewport.width()))
+            , _bottom(static_cast<float>(viewport.y() + viewport.height()))
+            , _near(clip_depth_range::negative_one_to_one == range ? -1.0f : 0.0f)
+        {
+            // pixel x = (x / w + 1) * width / 2 + left, and pixel y = (1 - y / w) * height / 2 + top; as rows of the
+            // matrix, divided by w.
+            const auto half_width = 0.5f * static_cast<float>(viewport.width());
+            const auto half_height = 0.5f * static_cast<float>(viewport.height());
+            for (auto i = 0u; i < 4; i++)
+            {
+                const auto x = view_projection(i, 0), y = view_projection(i, 1), w = view_projection(i, 3);
+                _rows[0][i] = half_width * x + (_left + half_width) * w;
+                _rows[1][i] = -half_height * y + (_top + half_height) * w;
+                _rows[2][i] = view_projection(i, 2);
+                _rows[3][i] = w;
+            }
+        }
+
+        // Gets the pixel coordinates of a position; meaningless when it's behind the camera.
+        point project(const vec3& position) const
+        {
+            const auto w = row(3, position);
+            return point(row(0, position) / w, row(1, position) / w);
+        }
+
+        // Whether a position is in front of the camera, between the near and far planes, and on a viewport pixel.
+        bool visible(const vec3& position) const
+        {
+            const auto pixel = project(position);
+            return inside(pixel.x, pixel.y, row(2, position), row(3, position));
+        }
+
+        // Projects count positions to pixel coordinates, setting bit i of visible ((count + 63) / 64 words) for those
+        // that are visible. bounds gets the bounding rect of the visible pixels; or an empty rect at the viewport's top
+        // left if there aren't any. The pixels of positions behind the camera are meaningless.
+        // Returns the number of visible positions.
+        size_t project(const vec3* const positions, const size_t count, point* const pixels, mask_type* const visible, raster_rectf& bounds) const
+        {
+            float min_x, min_y, max_x, max_y;
+            const auto hits = project_span(positions, count, pixels, visible, min_x, min_y, max_x, max_y);
+            bounds = 0 != hits ? raster_rectf(min_x, min_y, max_x - min_x, max_y - min_y) : raster_rectf(_left, _top, 0.0f, 0.0f);
+            return hits;
+        }
+
+        // Like the point overload, but gets the pixel each position lands in. bounds covers the visible pixels; so
+        // it's one wider and taller than the span of their coordinates. Positions far off screen are clamped to
+        // +/-2^30, so they still fit in a pointi.
+        size_t project(const vec3* const positions, const size_t count, pointi* const pixels, mask_type* const visible, raster_rect& bounds) const
+        {
+            float min_x, min_y, max_x, max_y;
+            const auto hits = project_span(positions, count, pixels, visible, min_x, min_y, max_x, max_y);
+            const auto left = static_cast<int_fast32_t>(std::floor(min_x)), top = static_cast<int_fast32_t>(std::floor(min_y));
+            bounds = 0 != hits ?
+                raster_rect(left, top, static_cast<int_fast32_t>(std::floor(max_x)) - left + 1, static_cast<int_fast32_t>(std::floor(max_y)) - top + 1) :
+                raster_rect(static_cast<int_fast32_t>(_left), static_cast<int_fast32_t>(_top), 0, 0);
+            return hits;
+        }
+
+    private:
+        float row(const unsigned int index, const vec3& position) const
+        {
+            const auto& r = _rows[index];
+            return r[0] * position.x + r[1] * position.y + r[2] * position.z + r[3];
+        }
+
+        bool inside(const float x, const float y, const float z, const float w) const
+        {
+            // A right-open test on the pixel coordinates, like raster_rect, so every visible point lands on a pixel.
+            return (0.0f < w) & (_left <= x) & (x < _right) & (_top <= y) & (y < _bottom) & (_near * w <= z) & (z <= w);
+        }
+
+        template<typename PointT>
+        size_t project_span(
+            const vec3* const positions,
+            const size_t count,
+            PointT* const pixels,
+            mask_type* const visible,
+            float& min_x,
+            float& min_y,
+            float& max_x,
+            float& max_y
+            ) const
+        {
+            assert((nullptr != positions && nullptr != pixels && nullptr != visible) || 0 == count);
+            CLG_INSTRUMENT_SCOPE("screen_projection::project", count);
+
+            // Local copies, so the compiler knows the stores can't change them.
+            float m[4][4];
+            for (auto i = 0u; i < 4; i++)
+            {
+                for (auto j = 0u; j < 4; j++)
+                {
+                    m[i][j] = _rows[i][j];
+                }
+            }
+            const auto left = _left, top = _top, right = _right, bottom = _bottom, near_depth = _near;
+            const auto limit = static_cast<float>(1 << 30);
+
+            const auto far_away = std::numeric_limits<float>::max();
+            min_x = min_y = far_away;
+            max_x = max_y = -far_away;
+            auto hits = size_t(0);
+            for (auto block = size_t(0); block < count; block += mask_bits)
+            {
+                // Flag the hits in a block first, with no branches, then pack the flags into bits.
+                const auto block_count = std::min(count - block, mask_bits);
+                const auto input = positions + block;
+                const auto output = pixels + block;
+                uint32_t flags[mask_bits];
+                auto block_hits = 0u;
+                for (auto j = size_t(0); j < block_count; j++)
+                {
+                    const auto& p = input[j];
+                    const auto x = m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3];
+                    const auto y = m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3];
+                    const auto z = m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3];
+                    const auto w = m[3][0] * p.x + m[3][1] * p.y + m[3][2] * p.z + m[3][3];
+
+                    // Behind the camera, divide by one instead, to keep the arithmetic finite.
+                    const auto inverse_w = 1.0f / (0.0f < w ? w : 1.0f);
+                    const auto pixel_x = std::min(std::max(x * inverse_w, -limit), limit);
+                    const auto pixel_y = std::min(std::max(y * inverse_w, -limit), limit);
+                    const auto hit = (0.0f < w) & (left <= pixel_x) & (pixel_x < right) & (top <= pixel_y) & (pixel_y < bottom) & (near_depth * w <= z) & (z <= w);
+
+                    if constexpr (std::is_integral_v<typename PointT::scalar_type>)
+                    {
+                        output[j][0] = static_cast<typename PointT::scalar_type>(std::floor(pixel_x));
+                        output[j][1] = static_cast<typename PointT::scalar_type>(std::floor(pixel_y));
+                    }
+                    else
+                    {
+                        output[j][0] = pixel_x;
+                        output[j][1] = pixel_y;
+                    }
+
+                    min_x = std::min(min_x, hit ? pixel_x : far_away);
+                    min_y = std::min(min_y, hit ? pixel_y : far_away);
+                    max_x = std::max(max_x, hit ? pixel_x : -far_away);
+                    max_y = std::max(max_y, hit ? pixel_y : -far_away);
+                    flags[j] = hit ? 1u : 0u;
+                    block_hits += flags[j];
+                }
+
+                mask_type bits = 0;
+                for (auto j = size_t(0); j < block_count; j++)
+                {
+                    bits |= mask_type(flags[j]) << j;
+                }
+                visible[block / mask_bits] = bits;
+                hits += block_hits;
+            }
+            return hits;
+        }
+
+        float   _rows[4][4];    // the pixel x, pixel y, clip z, and clip w rows; pixel coordinates are divided by w
+        float   _left;
+        float   _top;
+        float   _right;
+        float   _bottom;
+        float   _near;          // the clip depth of the near plane, per unit of w
+    };
+} // namespace clg
+
+#endif
@@ -0,0 +1,45 @@
+//
+// Copyright (c) 2021 Christopher Gassib
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// The instrumented configuration; its own program, since CLG_INSTRUMENT changes what the clg headers compile to.
+#define CLG_INSTRUMENT
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <limits>
+#include <atomic>
+#include <chrono>
+#include "clg_vector.hpp"
+#include "clg_rectangle.hpp"
+#include "clg_matrix.hpp"
+#include "clg_skinning.hpp"
+#include "clg_instrument.hpp"
+
+using namespace std;
+using namespace clg;
+
+int main()
+{
+    instrument_reset(); // void instrument_reset()
+    const auto hooked_model = translation_matrix(vec3(1.0f, 2.0f, 3.0f)) * rotation_matrix_z(trig<>::half_pi);
+    mat3 hooked_normals[2];
+    const mat4 hooked_models[] = { hooked_model, hooked_model * scaling_matrix(vec3(2.0f, 2.0f, 2.0f)) };
+    normal_matrices(hooked_models, array_count(hooked_models), hooked_normals);
+    cout << vec3(3.0f, 0.0f, 4.0f).unit() << ' ' << raster_rect(0, 0, 10, 10).overlaps(raster_rect(5, 5, 10, 10)) << '\n';
+    const auto instrumented = instrument_capture(); // instrument_snapshot instrument_capture()
+    for (auto op = 0u; op < static_cast<unsigned int>(instrument_op::count); op++)
+    {
+        cout << instrument_op_name(static_cast<instrument_op>(op)) << '=' << instrumented.op_counts[op] << ' ';
+    }
+    cout << instrumented.kernels.size() << ' ' << instrumented.kernels[0].name << ' ' << instrumented.kernels[0].calls << ' ' << instrumented.kernels[0].count << ' ' << instrumented.events.size() << '\n';
+    write_json(cout, instrumented); // void write_json(std::ostream& stream, const instrument_snapshot& snapshot)
+    cout << '\n';
+    write_chrome_trace(cout, &instrumented, 1); // void write_chrome_trace(std::ostream& stream, const instrument_snapshot* snapshots, size_t count)
+    cout << '\n';
+}
@@ -8,9 +8,31 @@
 #include <iomanip>
 #include <algorithm>
 #include <cassert>
+#include <vector>
+#include <limits>
+#include <cstring>
+#include <charconv>
+#include <string>
 #include "clg_vector.hpp"
 #include "clg_rectangle.hpp"
 #include "clg_matrix.hpp"
+#include "clg_rect_packer.hpp"
+#include "clg_rect_array.hpp"
+#include "clg_region.hpp"
+#include "clg_quadtree.hpp"
+#include "clg_binary.hpp"
+#include "clg_format.hpp"
+#include "clg_skinning.hpp"
+#include "clg_mesh.hpp"
+#include "clg_linalg.hpp"
+#include "clg_obb.hpp"
+#include "clg_affine.hpp"
+#include "clg_arena.hpp"
+#include "clg_tiles.hpp"
+#include "clg_instrument.hpp"
+#include "clg_frustum.hpp"
+#include "clg_viewport.hpp"
+#include "clg_polygon.hpp"
 
 using namespace std;
 using namespace clg;
@@ -290,6 +312,19 @@ int main()
     b2 = r7.overlaps(r8); //bool overlaps(const rect& rectangle) const
     cout << b2 << '\n';
 
+    rect clipped;
+    b2 = r5.intersect(r8, clipped); //bool intersect(const rect& rectangle, rect& intersection) const
+    cout << b2 << ' ' << clipped << ' ' << r5.make_intersection(r4) << '\n';
+    raster_rect clip_rect(-5, -5, 20, 20);
+    clip_rect.clip_to(raster_rect(0, 0, 10, 10)); //bool clip_to(const rect& bounds)
+    cout << "clipped: " << clip_rect << '\n';
+    raster_rect cut_pieces[4];
+    const auto cut_count = raster_rect(0, 0, 10, 10).subtract(raster_rect(2, 2, 4, 4), cut_pieces); //unsigned int subtract(const rect& rectangle, rect(&pieces)[4]) const
+    for (auto i = 0u; i < cut_count; i++)
+    {
+        cout << "piece: " << cut_pieces[i] << '\n';
+    }
+
     impl::vec<float, 4> v4va(1.5f, vec2(2.0f, 3.0f), 4.0f);
     impl::vec<float, 4> v4vb(vec2(2.0f, 3.0f), 1, 4);
     impl::vec<float, 4> v4vd(1, 4, vec2(2.0f, 3.0f));
@@ -583,4 +618,332 @@ int main()
 
     cout << interpolate<interp::smoothstep>(0, 10, 5) << '\n';
     cout << interpolate(interp::weighted_average(5.f), 0, 10, 5) << '\n';
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    skyline_packer<> atlas(sizevui(64, 64), sizevui(256, 256));
+    raster_rectui glyph;
+    atlas.insert(sizevui(12, 18), glyph); // bool insert(const size_type& size, rect_type& placement)
+    cout << "glyph: " << glyph << '\n';
+
+    const sizevui sprites[] = { sizevui(40, 40), sizevui(100, 20), sizevui(30, 70), sizevui(64, 64) };
+    raster_rectui sprite_placements[array_count(sprites)];
+    const auto placed = atlas.insert(sprites, array_count(sprites), sprite_placements); // size_t insert(const size_type* sizes, size_t count, rect_type* placements)
+    cout << placed << " placed in " << atlas.bin_size() << " occupancy: " << atlas.occupancy() << '\n';
+    for (const auto& placement : sprite_placements)
+    {
+        cout << "sprite: " << placement << '\n';
+    }
+
+    dirty_region<> damage(raster_rect(0, 0, 640, 480), 4);
+    damage.add(raster_rect(0, 0, 10, 10));
+    damage.add(raster_rect(10, 0, 10, 10)); // adjacent, merges with the first
+    damage.add(raster_rect(5, 5, 10, 10));  // overlapping, merges too
+    damage.add(raster_rect(300, 300, 8, 8));
+    damage.add(raster_rect(630, 470, 20, 20)); // clipped to the bounds
+    cout << damage.count() << " dirty rects, area: " << damage.area() << '\n';
+    for (const auto& dirty : damage.rects())
+    {
+        cout << "dirty: " << dirty << '\n';
+    }
+
+    const raster_rect windows[] = { raster_rect(0, 0, 100, 100), raster_rect(50, 50, 100, 100), raster_rect(100, 0, 50, 50) };
+    const region<int_fast32_t, InvertedYAxis, RightOpenIntervals> desktop(windows, array_count(windows));
+    const auto uncovered = desktop.subtract(raster_rect(25, 25, 50, 50)).intersect(raster_rect(0, 0, 120, 120));
+    cout << "region area: " << desktop.area() << " -> " << uncovered.area() << " in " << uncovered.rect_count() << " rects, bounds: " << uncovered.bounds() << '\n';
+    cout << uncovered.contains(pointi(30, 30)) << ' ' << uncovered.contains(pointi(10, 10)) << ' ' << uncovered.overlaps(raster_rect(110, 60, 5, 5)) << '\n';
+
+
+    const raster_rect widgets[] = { raster_rect(0, 0, 640, 480), raster_rect(10, 10, 100, 30), raster_rect(20, 15, 40, 10), raster_rect(600, 400, 40, 80) };
+    const rect_array<int_fast32_t, InvertedYAxis, RightOpenIntervals> widget_lanes(widgets, array_count(widgets));
+    rect_array<int_fast32_t, InvertedYAxis, RightOpenIntervals>::mask_type widget_mask[1];
+    const auto widget_hits = widget_lanes.contains(pointi(25, 20), widget_mask); // size_t contains(const point_type& point, mask_type* mask) const
+    cout << widget_hits << " hits, mask: " << widget_mask[0] << ", topmost: " << widget_lanes.last_containing(pointi(25, 20)) << ", first: " << widget_lanes.first_containing(pointi(25, 20)) << '\n';
+    cout << widget_lanes.overlaps(raster_rect(630, 470, 20, 20), widget_mask) << " overlaps, mask: " << widget_mask[0] << ", " << widget_lanes.get(3) << '\n';
+
+
+    quadtree<> scene(rect(0.0f, 0.0f, 1024.0f, 1024.0f), 6, 2);
+    const auto player = scene.insert(point(100.0f, 100.0f)); // handle_type insert(const point_type& point)
+    const auto crate = scene.insert(rect(120.0f, 90.0f, 16.0f, 16.0f));
+    const auto tree = scene.insert(rect(600.0f, 600.0f, 64.0f, 64.0f));
+    scene.insert(point(900.0f, 50.0f));
+    scene.update(player, point(110.0f, 102.0f)); // void update(handle_type handle, const point_type& point)
+    std::vector<quadtree<>::handle_type> nearby;
+    scene.query_radius(point(110.0f, 102.0f), 20.0f, nearby);
+    cout << scene.size() << " items in " << scene.node_count() << " nodes, " << nearby.size() << " near the player, crate bounds: " << scene.item_bounds(crate) << '\n';
+    quadtree<>::handle_type closest[2];
+    const auto closest_count = scene.k_nearest(point(650.0f, 500.0f), 2, closest); // size_t k_nearest(const point_type& point, size_t k, handle_type* results) const
+    cout << "nearest: " << (scene.nearest(point(0.0f, 200.0f)) == player) << ' ' << closest_count << ' ' << (closest[0] == tree) << '\n';
+    scene.remove(crate);
+    nearby.clear();
+    scene.query(rect(100.0f, 80.0f, 50.0f, 50.0f), nearby);
+    cout << nearby.size() << " in the area after removing the crate\n";
+    quadtree<> flock(rect(0.0f, 0.0f, 1024.0f, 1024.0f), 6, 2);
+    const auto bird = flock.insert(point(100.0f, 100.0f));
+    flock.insert(point(104.0f, 104.0f));
+    flock.insert(point(108.0f, 100.0f));
+    flock.update(bird, rect(92.0f, 92.0f, 16.0f, 16.0f)); // void update(handle_type handle, const rect_type& bounds); grows in place
+    nearby.clear();
+    flock.query(rect(92.0f, 107.0f, 1.0f, 1.0f), nearby);
+    flock.query_radius(point(92.0f, 92.0f), 0.5f, nearby);
+    cout << nearby.size() << " hits on the grown bird\n";
+
+
+    const vec3 vertices[] = { vec3(0.0f, 1.0f, 2.0f), vec3(3.0f, 4.0f, 5.0f), vec3(6.0f, 7.0f, 8.0f) };
+    const mat4 bind_pose = mat4::identity();
+    binary_writer scene_writer;
+    scene_writer.add(1, vertices, array_count(vertices)); // void add(uint32_t id, const T* elements, size_t count)
+    scene_writer.add(2, &bind_pose, 1);
+    scene_writer.add(3, widgets, array_count(widgets));
+    std::vector<uint8_t> scene_file(static_cast<size_t>(scene_writer.size()));
+    scene_writer.write(scene_file.data(), scene_file.size());
+    const binary_reader scene_reader(scene_file.data(), scene_file.size());
+    const auto loaded_vertices = scene_reader.view<vec3>(scene_reader.find(1)); // binary_view<T> view(size_t index) const
+    const auto loaded_widgets = scene_reader.view<raster_rect>(scene_reader.find(3));
+    cout << scene_file.size() << " bytes, " << scene_reader.section_count() << " sections, " << loaded_vertices.size() << " vertices: " << loaded_vertices[2] << '\n';
+    cout << loaded_widgets.size() << " widgets: " << loaded_widgets[1] << ", as recti: " << scene_reader.view<recti>(scene_reader.find(3)).size() << ", pose: " << scene_reader.view<mat4>(scene_reader.find(2)).size() << '\n';
+
+
+    char text[256];
+    auto formatted = to_chars(text, text + sizeof(text), v3, text_layout::pretty); // std::to_chars_result to_chars(char* first, char* last, const base_vec& value, text_layout layout)
+    cout << std::string(text, formatted.ptr) << " compact: ";
+    formatted = to_chars(text, text + sizeof(text), vec3(0.1f, -2.5f, 1e-7f));
+    cout << std::string(text, formatted.ptr) << '\n';
+    formatted = to_chars(text, text + sizeof(text), mat2(1.0f, -0.5f, 0.0f, 10.0f), text_layout::pretty);
+    cout << std::string(text, formatted.ptr) << '\n';
+    mat2 parsed_matrix;
+    const auto parsed = from_chars(text, formatted.ptr, parsed_matrix); // std::from_chars_result from_chars(const char* first, const char* last, mat& value)
+    formatted = to_chars(text, text + sizeof(text), parsed_matrix);
+    cout << (std::errc() == parsed.ec) << ' ' << std::string(text, formatted.ptr) << '\n';
+    raster_rect parsed_rect;
+    const char rect_text[] = "( 10, 20 ), ( 30, 40 )";
+    from_chars(rect_text, rect_text + sizeof(rect_text) - 1, parsed_rect);
+    formatted = to_chars(text, text + sizeof(text), parsed_rect);
+    cout << std::string(text, formatted.ptr) << ' ' << (std::errc::invalid_argument == from_chars(rect_text, rect_text + 5, parsed_rect).ec) << '\n';
+
+
+    rgbaui theme_colors[4];
+    const char theme_text[] = "#7FA0FF\n100, 180, 255\n0.5, 0.75, 1.0\n#F808";
+    const auto theme = parse_colors(theme_text, theme_text + sizeof(theme_text) - 1, theme_colors, array_count(theme_colors)); // parse_colors_result parse_colors(const char* first, const char* last, ColorT* colors, size_t capacity)
+    cout << theme.count << " colors:";
+    for (const auto& color : theme_colors)
+    {
+        formatted = color_to_chars(text, text + sizeof(text), color); // std::to_chars_result color_to_chars(char* first, char* last, const rgba& color, color_format format)
+        cout << ' ' << std::string(text, formatted.ptr);
+    }
+    formatted = color_to_chars(text, text + sizeof(text), rgb(0.5f, 0.75f, 1.0f), color_format::bytes);
+    cout << ", " << std::string(text, formatted.ptr);
+    formatted = color_to_chars(text, text + sizeof(text), argbui(0x80, 0x7f, 0xa0, 0xff), color_format::normalized);
+    cout << ", " << std::string(text, formatted.ptr) << '\n';
+
+
+    const mat4 skeleton[] = { mat4(), translation_matrix(vec3(0.0f, 2.0f, 0.0f)) * rotation_matrix_x(trig<>::half_pi) };
+    dual_quat skeleton_dq[array_count(skeleton)];
+    to_dual_quats(skeleton, array_count(skeleton), skeleton_dq); // void to_dual_quats(const mat4* matrices, size_t count, dual_quat* results)
+    cout << skeleton_dq[1].translation() << ' ' << skeleton_dq[1].transform_point(vec3(0.0f, 1.0f, 0.0f)) << ' ' << (skeleton_dq[1] * skeleton_dq[1].conjugate()).rotation() << '\n';
+    const vec3 skin_positions[] = { vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, 1.0f, 1.0f) };
+    const vec4 skin_weights[] = { vec4(1.0f, 0.0f, 0.0f, 0.0f), vec4(0.5f, 0.5f, 0.0f, 0.0f) };
+    const skin_joints skin_bones[] = { skin_joints(uint16_t(1), uint16_t(0), uint16_t(0), uint16_t(0)), skin_joints(uint16_t(0), uint16_t(1), uint16_t(0), uint16_t(0)) };
+    const skin_streams skin = { skin_positions, nullptr, skin_weights, skin_bones };
+    vec3 linear_skinned[2], dual_quat_skinned[2];
+    linear_blend_skin(skeleton, skin, linear_skinned, nullptr, 0, 2); // void linear_blend_skin(const mat4* bones, const skin_streams& vertices, vec3* positions, vec3* normals, size_t first, size_t last)
+    dual_quat_skin(skeleton_dq, skin, dual_quat_skinned, nullptr, 0, 2);
+    cout << linear_skinned[0] << ' ' << linear_skinned[1] << ", " << dual_quat_skinned[0] << ' ' << dual_quat_skinned[1] << '\n';
+
+
+    const auto posed = translation_matrix(vec3(1.0f, 2.0f, 3.0f)) * rotation_matrix_z(trig<>::half_pi) * shearing_matrix_xy(0.5f) * scaling_matrix(vec3(2.0f, 3.0f, -4.0f));
+    transform_parts pose_parts;
+    cout << decompose(posed, pose_parts) << ' '; // bool decompose(const mat4& matrix, transform_parts& parts)
+    cout << pose_parts.translation << ' ' << pose_parts.scale << ' ' << pose_parts.shear << '\n' << pose_parts.rotation;
+    cout << (compose(pose_parts) - posed) << '\n'; // mat4 compose(const transform_parts& parts)
+
+
+    const vec3 quad_positions[] = { vec3(0.0f, 0.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(1.0f, 1.0f, 1.0f), vec3(0.0f, 1.0f, 1.0f) };
+    const vec2 quad_uvs[] = { vec2(0.0f, 0.0f), vec2(1.0f, 0.0f), vec2(1.0f, 1.0f), vec2(0.0f, 1.0f) };
+    const uint16_t quad_indices[] = { 0, 1, 2, 0, 2, 3 };
+    vertex_triangles quad_adjacency;
+    quad_adjacency.build(quad_indices, 2, 4); // void build(const IndexT* indices, size_t triangle_count, size_t vertex_count)
+    vec3 quad_faces[2], quad_bitangents[2], quad_normals[4];
+    vec4 quad_tangents[4];
+    face_area_normals(quad_positions, quad_indices, quad_faces, 0, 2); // void face_area_normals(const vec3* positions, const IndexT* indices, vec3* normals, size_t first, size_t last)
+    vertex_normals(quad_adjacency, quad_faces, quad_normals, 0, 4); // void vertex_normals(const vertex_triangles& adjacency, const vec3* face_area_normals, vec3* normals, size_t first, size_t last)
+    face_tangents(quad_positions, quad_uvs, quad_indices, quad_faces, quad_bitangents, 0, 2);
+    vertex_tangents(quad_adjacency, quad_faces, quad_bitangents, quad_normals, quad_tangents, 0, 4);
+    cout << (quad_adjacency.end(0) - quad_adjacency.begin(0)) << " triangles at vertex 0, normal " << quad_normals[0] << " tangent " << quad_tangents[0] << '\n';
+    cout << normal_matrix(scaling_matrix(vec3(2.0f, 4.0f, 1.0f))) << '\n'; // mat3 normal_matrix(const mat4& model)
+
+
+    const mat3 system(2.0f, 0.0f, 0.0f, 0.0f, 3.0f, 0.0f, 1.0f, 0.0f, 4.0f);
+    vec3 solution;
+    cout << solve(system, vec3(3.0f, 3.0f, 4.0f), solution) << ' ' << solution; // bool solve(const mat<T, N, N>& a, const vec<T, N>& b, vec<T, N>& x)
+    lu_factors<float, 3> system_lu;
+    lu_decompose(system, system_lu); // bool lu_decompose(const mat<T, N, N>& a, lu_factors<T, N>& factors)
+    cout << ' ' << determinant(system_lu) << '\n' << inverse(system_lu) << '\n';
+    cout << "singular " << !lu_decompose(mat3(1.0f, 2.0f, 3.0f, 2.0f, 4.0f, 6.0f, 0.0f, 1.0f, 1.0f), system_lu) << '\n';
+    impl::mat<float, 2, 4> line_samples(0.0f, 1.0f, 2.0f, 3.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+    qr_factors<float, 2, 4> line_qr;
+    qr_decompose(line_samples, line_qr); // bool qr_decompose(const mat<T, C, R>& a, qr_factors<T, C, R>& factors)
+    cout << "line fit " << qr_solve(line_qr, impl::vec<float, 4>(1.0f, 3.1f, 4.9f, 7.0f)) << '\n'; // vec<T, C> qr_solve(const qr_factors<T, C, R>& factors, const vec<T, R>& b)
+    mat3 cholesky_lower;
+    cout << cholesky_decompose(mat3(4.0f, 2.0f, 0.0f, 2.0f, 5.0f, 1.0f, 0.0f, 1.0f, 3.0f), cholesky_lower) << '\n' << cholesky_lower << '\n'; // bool cholesky_decompose(const mat<T, N, N>& a, mat<T, N, N>& lower)
+
+
+    const mat3 inertia(2.0f, 1.0f, 0.0f, 1.0f, 2.0f, 0.0f, 0.0f, 0.0f, 5.0f);
+    vec3 principal_moments;
+    mat3 principal_axes;
+    symmetric_eigen(inertia, principal_moments, principal_axes); // void symmetric_eigen(const mat<T, 3, 3>& a, vec<T, 3>& values, mat<T, 3, 3>& vectors)
+    cout << principal_moments << '\n' << principal_axes << '\n';
+    const float covariance_xx[] = { 4.0f, 1.0f }, covariance_yy[] = { 1.0f, 1.0f }, covariance_zz[] = { 1.0f, 9.0f }, covariance_zero[] = { 0.0f, 0.0f };
+    float spread[3][2], spread_axes[9][2];
+    float* const spread_values[] = { spread[0], spread[1], spread[2] };
+    float* const spread_vectors[] = { spread_axes[0], spread_axes[1], spread_axes[2], spread_axes[3], spread_axes[4], spread_axes[5], spread_axes[6], spread_axes[7], spread_axes[8] };
+    symmetric_eigen(symmetric3_streams<float>{ covariance_xx, covariance_yy, covariance_zz, covariance_zero, covariance_zero, covariance_zero }, spread_values, spread_vectors, 0, 2);
+    cout << spread[0][0] << ' ' << spread[0][1] << ' ' << vec3(spread_axes[0][1], spread_axes[1][1], spread_axes[2][1]) << '\n';
+    mat3 svd_u, svd_v, polar_rotation, polar_stretch;
+    vec3 singular_values;
+    svd(mat3(scaling_matrix(vec3(1.0f, -2.0f, 3.0f))), svd_u, singular_values, svd_v); // void svd(const mat<T, 3, 3>& a, mat<T, 3, 3>& u, vec<T, 3>& sigma, mat<T, 3, 3>& v)
+    polar_decompose(mat3(rotation_matrix_z(trig<>::half_pi) * scaling_matrix(vec3(2.0f, 3.0f, 4.0f))), polar_rotation, polar_stretch);
+    cout << singular_values << '\n' << polar_rotation << '\n' << polar_stretch << '\n';
+
+
+    const obb3 unit_box(vec3(0.0f, 0.0f, 0.0f), vec3(1.0f, 1.0f, 1.0f));
+    const auto turned_box = unit_box.transformed(translation_matrix(vec3(2.5f, 0.0f, 0.0f)) * rotation_matrix_z(trig<>::half_pi / 2.0f)); // obb transformed(const mat<T, D + 1, D + 1>& transform) const
+    cout << turned_box.center() << ' ' << turned_box.half_extents() << ' ' << unit_box.overlaps(turned_box) << '\n'; // bool overlaps(const obb& rhs) const
+    const vec3 box_points[] = { vec3(0.0f, 0.0f, 0.0f), vec3(4.0f, 4.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(4.0f, 3.0f, 0.0f), vec3(0.0f, 1.0f, 1.0f) };
+    const auto fitted_box = fit_obb(box_points, array_count(box_points)); // obb<T, D> fit_obb(const vec<T, D>* points, size_t count)
+    cout << fitted_box.half_extents() << ' ' << fitted_box.contains(vec3(2.0f, 2.0f, 0.0f)) << '\n';
+    const obb2 panels[] = { obb2(vec2(1.5f, 0.0f), vec2(0.5f, 0.5f)), obb2(vec2(3.0f, 0.0f), vec2(0.5f, 0.5f)), obb2(vec2(0.0f, 1.2f), vec2(1.0f, 0.25f), mat2(0.0f, 1.0f, -1.0f, 0.0f)) };
+    obb2::mask_type panel_hits;
+    cout << overlaps(obb2(vec2(0.0f, 0.0f), vec2(1.0f, 1.0f)), panels, array_count(panels), &panel_hits) << ' ' << panel_hits << '\n'; // size_t overlaps(const obb& box, const obb* boxes, size_t count, mask_type* mask)
+
+
+    const auto widget_view = affine2::translation(vec2(10.0f, 20.0f)) * affine2::rotation(trig<>::half_pi) * affine2::scaling(vec2(2.0f, 2.0f)); // affine operator *(const affine& rhs) const
+    cout << widget_view.transform_point(point(1.0f, 0.0f)) << ' ' << widget_view.transform_vector(vec2(1.0f, 0.0f)) << ' ' << widget_view.inverse().transform_point(point(10.0f, 22.0f)) << '\n';
+    const auto widget_bounds = affine2(shearing_matrix_x(1.0f)).transform(rect(0.0f, 0.0f, 4.0f, 2.0f)); // rect transform(const rect& rectangle) const
+    cout << widget_bounds.x() << ' ' << widget_bounds.y() << ' ' << widget_bounds.width() << ' ' << widget_bounds.height() << '\n';
+    point widget_corners[] = { point(0.0f, 0.0f), point(4.0f, 0.0f), point(4.0f, 2.0f) };
+    transform_points(affine2(translation_matrix(vec2(4.0f, 5.0f))), widget_corners, widget_corners, array_count(widget_corners)); // void transform_points(const affine& transform, const vec_type* input, vec_type* output, size_t count)
+    cout << widget_corners[0] << ' ' << widget_corners[2] << '\n';
+
+
+    frame_arena scratch(256);
+    for (auto frame = 0; frame < 2; frame++)
+    {
+        scratch.reset(); // void reset()
+        auto scratch_bones = scratch.allocate<mat4, 64>(2); // T* allocate<T, Alignment>(size_t count)
+        scratch_bones[0] = mat4();
+        std::vector<vec4, arena_allocator<vec4>> scratch_lights{ arena_allocator<vec4>(scratch) };
+        scratch_lights.assign(12, vec4(1.0f));
+        const auto scratch_usage = scratch.statistics(); // arena_statistics statistics() const
+        cout << (0 == reinterpret_cast<uintptr_t>(scratch_bones) % 64) << ' ' << scratch_usage.capacity << ' ' << scratch_usage.used << ' ' << scratch_usage.high_water_mark << ' ' << scratch_usage.overflow_count << '\n';
+    }
+
+
+    vec3 big_endian_positions[] = { vec3(1.0f, -2.0f, 0.5f), vec3(3.0f, 4.0f, 5.0f) };
+    byte_swap_span(big_endian_positions, array_count(big_endian_positions)); // void byte_swap_span(T* values, size_t count)
+    vec3 native_positions[2];
+    byte_swap_span(big_endian_positions, native_positions, array_count(big_endian_positions)); // void byte_swap_span(const T* input, T* output, size_t count)
+    cout << native_positions[0] << ' ' << native_positions[1] << ' ' << std::hex << byte_swap(int16_t(-256)) << ' ' << byte_swap(uint32_t(0x11223344)) << std::dec << ' ' << byte_swap(byte_swap(2.5)) << '\n';
+
+
+    cout << mix(1.0f, 3.0f, 0.25f) << ' ' << mix(vec3(0.0f, 2.0f, 4.0f), vec3(4.0f, 2.0f, 0.0f), 0.5f) << '\n' << mix(mat3(), mat3(3.0f), 0.5f) << '\n'; // T mix(const T& a, const T& b, scalar_type t)
+    const rgba fade_from[] = { rgba(0.0f, 0.0f, 0.0f, 1.0f), rgba(1.0f, 1.0f, 1.0f, 1.0f) };
+    const rgba fade_to[] = { rgba(1.0f, 0.5f, 0.0f, 1.0f), rgba(0.0f, 0.0f, 0.0f, 0.0f) };
+    const float fade_weights[] = { 0.25f, 0.5f };
+    rgba faded[2];
+    mix(fade_from, fade_to, fade_weights, faded, 2, interp::smoothstep()); // void mix(const T* a, const T* b, const float* t, T* results, size_t count, interpolate_func interp)
+    cout << faded[0] << ' ' << faded[1] << ' ';
+    mix(fade_from, fade_to, interpolate<interp::quadratic>(0.0f, 2.0f, 1.0f), faded, 2); // void mix(const T* a, const T* b, scalar_type t, T* results, size_t count)
+    cout << faded[0] << '\n';
+    const vec4 spin_from = quat_from_matrix(mat3(rotation_matrix_z(0.0f))), spin_to = quat_from_matrix(mat3(rotation_matrix_z(trig<>::half_pi)));
+    cout << quat_slerp(spin_from, spin_to, 0.5f) << ' ' << quat_nlerp(spin_from, -spin_to, 0.5f) << '\n'; // vec4 quat_slerp(const vec4& a, const vec4& b, float t)
+
+
+    const raster_rectui huge_tile(10u, 10u, std::numeric_limits<uint_fast32_t>::max(), 5u);
+    raster_rectui tile_union;
+    cout << (huge_tile.right() < huge_tile.x()) << ' ' << (saturating_right(huge_tile) == std::numeric_limits<uint_fast32_t>::max()) << ' ' << checked_union(huge_tile, raster_rectui(0u, 0u, 4u, 4u), tile_union) << '\n'; // bool checked_union(const rect& lhs, const rect& rhs, rect& union_rect)
+    cout << saturating_add(int8_t(100), int8_t(100)) + 0 << ' ' << saturating_sub(3u, 5u) << ' ' << saturating_union(raster_rect(-5, 0, 10, 10), raster_rect(20, 20, 5, 5)) << '\n'; // T saturating_add(T lhs, T rhs)
+    const raster_rect viewport(0, 0, 1920, 1080);
+    const raster_rect tiles[] = { raster_rect(-32, -32, 64, 64), raster_rect(1900, 1060, 64, 64), raster_rect(2000, 0, 64, 64), raster_rect(64, 64, 64, 64) };
+    raster_rect clipped_tiles[array_count(tiles)];
+    cout << clip_rects(tiles, array_count(tiles), viewport, clipped_tiles) << ' ' << clipped_tiles[0] << ' ' << clipped_tiles[1] << ' ' << clipped_tiles[2] << '\n'; // size_t clip_rects(const rect* rects, size_t count, const rect& bounds, rect* results)
+    raster_rectui flipped_tile;
+    cout << checked_to_raster_rect(rect(0.0f, 0.0f, 10.0f, 10.0f), 5, flipped_tile) << ' ' << checked_to_raster_rect(rect(0.0f, 0.0f, 10.0f, 10.0f), 50, flipped_tile) << ' ' << flipped_tile << '\n'; // bool checked_to_raster_rect(const rect& rectangle, int_fast32_t client_height, raster_rect& result)
+
+
+    const tile_grid screen_tiles(200, 100, 64, 48);
+    cout << screen_tiles.columns() << ' ' << screen_tiles.rows() << ' ' << screen_tiles.tile_rect(3, 2) << '\n';
+    for (const auto& tile : screen_tiles.covered(raster_rect(60, 40, 10, 20))) // tile_span covered(const rect& rectangle) const
+    {
+        cout << tile << ' ';
+    }
+    cout << screen_tiles.covered(rect(-10.0f, 47.5f, 10.0f, 0.0f)).size() << ' ' << screen_tiles.covered(raster_rect(200, 0, 10, 10)).empty() << '\n';
+    const raster_rect draw_rects[] = { raster_rect(0, 0, 100, 10), raster_rect(70, 50, 1, 1), raster_rect(10, 5, 1, 1) };
+    tile_bins sprite_bins;
+    sprite_bins.build(screen_tiles, draw_rects, array_count(draw_rects)); // void build(const tile_grid& grid, const rect* rects, size_t count)
+    for (auto sprite = sprite_bins.begin(0); sprite != sprite_bins.end(0); sprite++) // const uint32_t* begin(size_t tile) const
+    {
+        cout << *sprite << ' ';
+    }
+    cout << (sprite_bins.end(1) - sprite_bins.begin(1)) << ' ' << (sprite_bins.end(5) - sprite_bins.begin(5)) << '\n';
+
+
+    const auto camera_projection = perspective_projection_matrix_gl(trig<>::half_pi, 1.0f, 1.0f, 100.0f);
+    const auto camera_frustum = frustum_from_matrix_gl(camera_projection); // frustum frustum_from_matrix_gl(const mat4& view_projection)
+    cout << camera_frustum.plane(frustum::near_plane) << ' ' << camera_frustum.plane(frustum::left_plane) << ' ' << camera_frustum.contains(vec3(0.0f, 0.0f, -50.0f)) << camera_frustum.contains(vec3(0.0f, 0.0f, 50.0f)) << '\n';
+    const vec4 scenery[] = { vec4(0.0f, 0.0f, -10.0f, 1.0f), vec4(0.0f, 0.0f, 10.0f, 1.0f), vec4(10.0f, 0.0f, -10.0f, 1.0f), vec4(0.0f, 0.0f, -100.0f, 5.0f) };
+    culling_cache scenery_culling;
+    scenery_culling.build(scenery, array_count(scenery)); // void build(const vec4* spheres, size_t count)
+    culling_cache::mask_type scenery_visible;
+    for (auto frame = 0; frame < 3; frame++)
+    {
+        const auto camera = translation_matrix(vec3(0.0f, 0.0f, 0.01f * frame));
+        const auto visible_count = scenery_culling.cull(frustum_from_matrix_gl(camera_projection * camera), &scenery_visible); // size_t cull(const frustum& view, mask_type* visible)
+        const auto& culling = scenery_culling.statistics();
+        cout << visible_count << ' ' << scenery_visible << ' ' << culling.tested << ' ' << culling.reused << ' ' << culling.hit_rate() << ' ' << int(scenery_culling.plane_mask(0)) << ' ' << int(scenery_culling.plane_mask(3)) << '\n';
+    }
+
+
+    const auto far_away = std::numeric_limits<float>::infinity();
+    const auto reversed_projection = reversed_z_perspective_projection_matrix_dx(trig<>::half_pi, 1.0f, 0.5f, far_away); // mat4 reversed_z_perspective_projection_matrix_dx(float verticalFieldOfView, float aspectRatioWidthOverHeight, float near, float far)
+    cout << reversed_projection << '\n' << infinite_perspective_projection_matrix_gl(trig<>::half_pi, 1.0f, 0.5f) << '\n';
+    const depth_linearizer reversed_depth(reversed_projection, clip_depth_range::zero_to_one); // depth_linearizer(const mat4& projection, clip_depth_range range)
+    const depth_linearizer gl_depth(perspective_projection_matrix_gl(trig<>::half_pi, 1.0f, 1.0f, 100.0f), clip_depth_range::negative_one_to_one);
+    float depth_samples[] = { 1.0f, 0.5f, 0.05f, 0.0f };
+    reversed_depth.linearize(depth_samples, depth_samples, array_count(depth_samples)); // void linearize(const float* depths, float* view_depths, size_t count) const
+    cout << depth_samples[0] << ' ' << depth_samples[1] << ' ' << depth_samples[2] << ' ' << depth_samples[3] << ' ';
+    reversed_depth.delinearize(depth_samples, depth_samples, 3); // void delinearize(const float* view_depths, float* depths, size_t count) const
+    cout << depth_samples[0] << ' ' << depth_samples[1] << ' ' << depth_samples[2] << ' ' << gl_depth.linearize(0.0f) << ' ' << gl_depth.linearize(1.0f) << ' ' << gl_depth.delinearize(1.0f) << '\n';
+
+
+    const screen_projection to_screen(perspective_projection_matrix_gl(trig<>::half_pi, 2.0f, 1.0f, 100.0f), raster_rect(0, 0, 200, 100)); // screen_projection(const mat4& view_projection, const raster_rect& viewport, clip_depth_range range)
+    cout << to_screen.project(vec3(0.0f, 0.0f, -10.0f)) << ' ' << to_screen.project(vec3(-5.0f, 2.5f, -5.0f)) << ' ' << to_screen.visible(vec3(0.0f, 0.0f, -10.0f)) << to_screen.visible(vec3(0.0f, 0.0f, 10.0f)) << to_screen.visible(vec3(0.0f, 0.0f, -200.0f)) << '\n';
+    const vec3 markers[] = { vec3(0.0f, 0.0f, -10.0f), vec3(-10.0f, 5.0f, -10.0f), vec3(0.0f, 0.0f, 10.0f), vec3(5.0f, -2.0f, -10.0f), vec3(50.0f, 0.0f, -10.0f) };
+    point marker_pixels[array_count(markers)];
+    pointi marker_raster[array_count(markers)];
+    screen_projection::mask_type marker_visible;
+    raster_rectf marker_bounds;
+    raster_rect marker_raster_bounds;
+    cout << to_screen.project(markers, array_count(markers), marker_pixels, &marker_visible, marker_bounds) << ' ' << marker_visible << ' ' << marker_bounds << ' ' << marker_pixels[3] << '\n'; // size_t project(const vec3* positions, size_t count, point* pixels, mask_type* visible, raster_rectf& bounds) const
+    cout << to_screen.project(markers, array_count(markers), marker_raster, &marker_visible, marker_raster_bounds) << ' ' << marker_visible << ' ' << marker_raster_bounds << ' ' << marker_raster[3] << '\n'; // size_t project(const vec3* positions, size_t count, pointi* pixels, mask_type* visible, raster_rect& bounds) const
+
+
+    const pointi outline[] = { pointi(0, 0), pointi(8, 0), pointi(8, 2), pointi(2, 2), pointi(2, 6), pointi(0, 6) };
+    cout << polygon_signed_area(outline, array_count(outline)) << ' ' << (polygon_winding::counter_clockwise == polygon_winding_order(outline, array_count(outline))) << '\n'; // double polygon_signed_area(const impl::point<ScalarT>* polygon, size_t count)
+    polygon_workspacei outline_scratch;
+    uint16_t outline_indices[3 * (array_count(outline) - 2)];
+    const auto outline_triangles = outline_scratch.triangulate(outline, array_count(outline), outline_indices); // size_t triangulate(const point_type* polygon, size_t count, IndexT* triangles)
+    for (auto i = size_t(0); i < outline_triangles * 3; i++)
+    {
+        cout << outline_indices[i] << (2 == i % 3 ? "; " : " ");
+    }
+    pointi outline_hull[array_count(outline)];
+    const auto outline_hull_count = outline_scratch.convex_hull(outline, array_count(outline), outline_hull); // size_t convex_hull(const point_type* points, size_t count, point_type* hull)
+    for (auto i = size_t(0); i < outline_hull_count; i++)
+    {
+        cout << outline_hull[i] << ' ';
+    }
+    const pointi probes[] = { pointi(3, 1), pointi(5, 4), pointi(1, 5), pointi(-1, 0) };
+    polygon_workspacei::mask_type probes_inside;
+    cout << outline_scratch.contains(outline, array_count(outline), probes, array_count(probes), &probes_inside) << ' ' << probes_inside << '\n'; // size_t contains(const point_type* polygon, size_t polygon_count, const point_type* points, size_t count, mask_type* inside)
 }